@@ -1,4 +1,5 @@
 typedef struct csip_model CSIP_MODEL;
+typedef struct csip_cache CSIP_CACHE;
 
 /* return codes */
 typedef int CSIP_RETCODE;
@@ -41,8 +42,36 @@ typedef int CSIP_OP;
 #define POW 14
 #define EXP 17
 #define LOG 18
+#define OPSQUARE 12
+#define OPINTPOWER 15
+#define OPSIN 19
+#define OPCOS 20
+#define OPMIN 24
+#define OPMAX 25
+#define OPABS 26
 #define SUM 64
 #define PROD 65
+#define LINEAR 66
+#define QUADRATIC 67
+#define POLYNOMIAL 68
+
+/* message types for log callbacks */
+typedef int CSIP_MSGTYPE;
+#define CSIP_MSGTYPE_INFO 0
+#define CSIP_MSGTYPE_WARNING 1
+#define CSIP_MSGTYPE_DIALOG 2
+
+/* phases of lazy and heuristic callbacks, for timing */
+typedef int CSIP_PHASE;
+#define CSIP_PHASE_LAZYCALLBACK 0     // user's lazy callback (including below)
+#define CSIP_PHASE_LAZYGETVARVALUES 1 // CSIPlazyGetVarValues
+#define CSIP_PHASE_LAZYCREATECONS 2   // creating cons in CSIPlazyAddLinCons
+#define CSIP_PHASE_LAZYCHECKCONS 3    // checking cons in CSIPlazyAddLinCons
+#define CSIP_PHASE_LAZYADDCONS 4      // adding cons in CSIPlazyAddLinCons
+#define CSIP_PHASE_HEURCALLBACK 5     // user's heuristic (including below)
+#define CSIP_PHASE_HEURGETVARVALUES 6 // CSIPheurGetVarValues
+#define CSIP_PHASE_HEURADDSOLUTION 7  // CSIPheurAddSolution
+#define CSIP_NPHASES 8
 
 /* parameter types */
 typedef int CSIP_PARAMTYPE;
@@ -77,6 +106,13 @@ CSIP_RETCODE CSIPaddVar(
     CSIP_MODEL *model, double lowerbound, double upperbound,
     CSIP_VARTYPE vartype, int *idx);
 
+// Add several variables at once, with indices following the current number of
+// variables. The names are optional: names or any of its entries can be NULL,
+// in which case a variable with index i is named "x<i>".
+CSIP_RETCODE CSIPaddVars(
+    CSIP_MODEL *model, int numvars, double *lowerbounds, double *upperbounds,
+    CSIP_VARTYPE *vartypes, const char **names);
+
 // Set new lower bounds for a set of variables.
 CSIP_RETCODE CSIPchgVarLB(
     CSIP_MODEL *model, int numindices, int *indices, double *lowerbounds);
@@ -129,6 +165,16 @@ CSIP_RETCODE CSIPaddQuadCons(
 // VARIDX are 2 -> the variables with index 2 (x_2)
 // CONST are 0 -> the value with index 0 (2.0)
 // POWER are 0, 1 -> the variable and the const (x_2 ^ 2.0)
+// OPINTPOWER is like POW, with an integral exponent. OPMIN and OPMAX have two
+// children; OPSQUARE, OPSIN, OPCOS and OPABS have one.
+// The n-ary nodes refer to the values array for their coefficients:
+// LINEAR has k children ops, then k+1 values: the coefficients and a constant.
+// QUADRATIC has the number of children k, the k children ops, the values of the
+// constant and the k linear coefficients, then a triple (i, j, value of coef)
+// per product of the i-th and j-th child.
+// POLYNOMIAL has k, the k children ops and the value of the constant, then per
+// monomial its number of factors f, the value of its coefficient and f pairs
+// (i, value of exponent) for a factor child_i ^ exponent.
 // The constraint index will be assigned to idx; pass NULL if not needed.
 CSIP_RETCODE CSIPaddNonLinCons(
     CSIP_MODEL *model, int nops, CSIP_OP *ops, int *children, int *begin,
@@ -150,10 +196,63 @@ CSIP_RETCODE CSIPaddSOS1(
 CSIP_RETCODE CSIPaddSOS2(
     CSIP_MODEL *model, int numindices, int *indices, double *weights, int *idx);
 
+// Add several SOS1 or SOS2 constraints at once, with indices following the
+// current number of constraints. Set k consists of the variables
+// indices[begin[k]] to [begin[k+1]-1], with the corresponding weights, or NULL.
+CSIP_RETCODE CSIPaddSOS1Batch(
+    CSIP_MODEL *model, int nsets, int *begin, int *indices, double *weights);
+CSIP_RETCODE CSIPaddSOS2Batch(
+    CSIP_MODEL *model, int nsets, int *begin, int *indices, double *weights);
+
+// Add the constraint y = f(x) for the piecewise linear function f through the
+// points (xs[i], ys[i]), with xs increasing, and x restricted to [xs[0],
+// xs[npoints-1]]. This adds npoints variables (the weights of the points), with
+// indices following the current number of variables, and four constraints,
+// with indices following the current number of constraints.
+CSIP_RETCODE CSIPaddPiecewiseLinear(
+    CSIP_MODEL *model, int xidx, int yidx, int npoints, double *xs, double *ys);
+
+// Add new indicator constraint to the model, of the form:
+//    vars[binindex] = activeval  ->  lhs <= sum_i coefs[i] * vars[i] <= rhs
+// where vars[binindex] is binary and activeval is 0 or 1.
+// For one-sided inequalities, use (-)INFINITY for lhs or rhs. A two-sided row
+// is added as two constraints with consecutive indices. Invalid rows give
+// CSIP_RETCODE_ERROR; CSIPaddIndicators then adds none of its rows.
+// The (first) constraint index will be assigned to idx; pass NULL if not needed.
+CSIP_RETCODE CSIPaddIndicator(
+    CSIP_MODEL *model, int binindex, int activeval, int numindices,
+    int *indices, double *coefs, double lhs, double rhs, int *idx);
+
+// Add several indicator constraints at once, with indices following the current
+// number of constraints. Row k has the coefficients indices/coefs[begin[k]] to
+// [begin[k+1]-1]. As two-sided rows take two constraints, the (first) index of
+// the constraint of row k is assigned to idx[k]; pass NULL if not needed.
+CSIP_RETCODE CSIPaddIndicators(
+    CSIP_MODEL *model, int ncons, int *binindices, int *activevals, int *begin,
+    int *indices, double *coefs, double *lhss, double *rhss, int *idx);
+
+// Make variables semicontinuous: each takes the value 0 or a value of at least
+// lowerbounds[i], within its bounds. The variables must have a lower bound of
+// 0 and lowerbounds[i] must be positive and at most the upper bound, otherwise
+// CSIP_RETCODE_ERROR is returned and nothing is added.
+// Adds one constraint per variable, with indices following the current number
+// of constraints.
+CSIP_RETCODE CSIPaddSemicontinuous(
+    CSIP_MODEL *model, int numindices, int *indices, double *lowerbounds);
+
 // Set the linear objective function of the form: sum_i coefs[i] * vars[i]
 CSIP_RETCODE CSIPsetObj(
     CSIP_MODEL *model, int numindices, int *indices, double *coefs);
 
+// Change the objective coefficients of some variables, leaving all others (and
+// a nonlinear objective, if any) as they are. Only coefficients that actually
+// change are passed to SCIP; if none changes, the problem is not retransformed.
+CSIP_RETCODE CSIPchgObjCoefs(
+    CSIP_MODEL *model, int numindices, int *indices, double *coefs);
+
+// Remove the objective, linear and nonlinear: all coefficients become zero.
+CSIP_RETCODE CSIPclearObj(CSIP_MODEL *model);
+
 // Set a quadratic objective function
 CSIP_RETCODE CSIPsetQuadObj(CSIP_MODEL *model, int numlinindices,
                             int *linindices, double *lincoefs, int numquadterms,
@@ -175,6 +274,59 @@ CSIP_RETCODE CSIPsetSenseMaximize(CSIP_MODEL *model);
 // Solve the model.
 CSIP_RETCODE CSIPsolve(CSIP_MODEL *model);
 
+// Solve the model with the given variables fixed to values within their bounds
+// (integral for integer variables), for this solve only. The bounds of the
+// model are not changed.
+CSIP_RETCODE CSIPsolveWithFixings(CSIP_MODEL *model, int numindices,
+                                  int *indices, double *values);
+
+// Solve with several linear objectives in lexicographic order, each given in
+// sparse row format: objective k has the coefficients indices/coefs[begin[k]]
+// to [begin[k+1]-1]. After a stage is solved, a linear constraint keeps its
+// objective within tolerances[k] (absolute, may be NULL for 0) of the optimal
+// value, and the solution is used as a start for the next stage. These
+// constraints and the last objective remain in the model, so that the solution
+// of the last stage can be queried. Stops at the first stage that is not
+// solved to optimality; check CSIPgetStatus. If not NULL, objvalues receives the
+// optimal value of each solved stage, and considx (of size nobjs-1) the indices
+// of the added constraints, -1 for stages not reached; remove them with
+// CSIPdelConss when done with the solution.
+CSIP_RETCODE CSIPsolveLexicographic(
+    CSIP_MODEL *model, int nobjs, int *begin, int *indices, double *coefs,
+    double *tolerances, double *objvalues, int *considx);
+
+// Changes of a scenario with respect to the model: new sides for some (linear
+// or quadratic) constraints and new bounds for some variables. Indices must be
+// unique within a scenario.
+typedef struct
+{
+    int nconss;
+    int *consindices;
+    double *lhss;
+    double *rhss;
+    int nvars;
+    int *varindices;
+    double *lbs;
+    double *ubs;
+} CSIP_SCENARIO;
+
+// Solve the model once for each scenario. After solving a scenario, the next
+// one is the unsolved scenario closest to it, and its solution is given as a
+// start. The status, the objective value and the values of the variables in
+// solindices are stored at the position of the scenario in statuses, objvalues
+// and solvalues (nscenarios * nsolindices, row-wise); NaN if there is no
+// solution. objvalues and solvalues may be NULL. Afterwards, the model is in
+// its original state and has no solution.
+// Indices out of range and constraints other than linear or quadratic ones give
+// CSIP_RETCODE_ERROR before any scenario is solved.
+// Models without callbacks are copied (with their parameters) to solve
+// scenarios in parallel, one thread per processor. The copies do not print
+// any output. Models with callbacks solve all scenarios in the calling thread.
+CSIP_RETCODE CSIPsolveScenarios(
+    CSIP_MODEL *model, int nscenarios, CSIP_SCENARIO *scenarios,
+    int nsolindices, int *solindices, CSIP_STATUS *statuses, double *objvalues,
+    double *solvalues);
+
 // Interrupt the solving process.
 CSIP_RETCODE CSIPinterrupt(CSIP_MODEL *model);
 
@@ -191,6 +343,37 @@ double CSIPgetObjBound(CSIP_MODEL *model);
 // Get the solving status.
 CSIP_STATUS CSIPgetStatus(CSIP_MODEL *model);
 
+// statistics of the last solve
+typedef struct
+{
+    double presolvingtime;      // time spent in presolving
+    double rootlptime;          // time spent to solve the first root LP
+    double solvingtime;         // total solving time
+    long long nlpiterations;    // total number of LP iterations
+    long long nnodes;           // number of processed nodes
+    int maxdepth;               // maximal depth of the branch-and-bound tree
+    int ncutsapplied;           // total number of cuts applied to the LP
+
+    long long nlazycalls;       // number of calls of lazy callbacks
+    double lazytime;            // time spent in lazy callbacks
+    long long nheurcalls;       // number of calls of heuristic callbacks
+    double heurtime;            // time spent in heuristic callbacks
+
+    // per separator: name and number of cuts found
+    int nsepas;
+    const char **sepanames;
+    long long *sepancuts;
+
+    // per heuristic: name and time spent
+    int nheurs;
+    const char **heurnames;
+    double *heurtimes;
+} CSIP_SOLVESTATS;
+
+// Get statistics of the last solve. The per-plugin arrays are owned by the
+// model and valid until the next call of this function or CSIPfreeModel.
+CSIP_RETCODE CSIPgetSolveStats(CSIP_MODEL *model, CSIP_SOLVESTATS *stats);
+
 // Get the type of a parameter
 CSIP_PARAMTYPE CSIPgetParamType(CSIP_MODEL *model, const char *name);
 
@@ -225,11 +408,73 @@ int CSIPgetNumVars(CSIP_MODEL *model);
 // Beware: constraints added by a lazy callbacks are not counted here!
 int CSIPgetNumConss(CSIP_MODEL *model);
 
+// Delete variables from the model. The remaining variables keep their order
+// and get consecutive indices. If newindices is not NULL, it must have room for
+// one entry per variable before the deletion and receives the new index of
+// each, or -1 for deleted ones.
+// Deleted variables are removed from linear constraints and the linear
+// objective. Variables used in any other constraint, including inactive ones,
+// or in a nonlinear objective cannot be deleted; the call then returns
+// CSIP_RETCODE_ERROR and leaves the model unchanged.
+CSIP_RETCODE CSIPdelVars(CSIP_MODEL *model, int numindices, int *indices,
+                         int *newindices);
+
+// Delete constraints from the model, with indices remapped as in CSIPdelVars.
+// For indices out of range, both return CSIP_RETCODE_ERROR and leave the model
+// unchanged.
+CSIP_RETCODE CSIPdelConss(CSIP_MODEL *model, int numindices, int *indices,
+                          int *newindices);
+
+// Activate or deactivate constraints. Inactive constraints are removed from
+// the problem, but keep their index and can be activated again for later solves.
+CSIP_RETCODE CSIPsetConsActive(CSIP_MODEL *model, int numindices, int *indices,
+                               int active);
+
+// Return whether a constraint is active.
+int CSIPisConsActive(CSIP_MODEL *model, int idx);
+
+// Add constraints to the group of the given name, creating it if needed.
+CSIP_RETCODE CSIPaddConsGroup(CSIP_MODEL *model, const char *name,
+                              int numindices, int *indices);
+
+// Activate or deactivate all constraints of a group.
+CSIP_RETCODE CSIPsetConsGroupActive(CSIP_MODEL *model, const char *name,
+                                    int active);
+
+// Set the name of a variable or constraint. Without a name, they are named by
+// their index as "x<i>" and "c<i>", where after deletions the index counts the
+// deleted ones as well. Names should be unique.
+CSIP_RETCODE CSIPsetVarName(CSIP_MODEL *model, int idx, const char *name);
+CSIP_RETCODE CSIPsetConsName(CSIP_MODEL *model, int idx, const char *name);
+
+// Set the names of several variables or constraints at once: the entity with
+// index indices[i] gets names[i]. Use this after a bulk add, e.g.,
+// CSIPaddSOS1Batch or CSIPaddIndicators, instead of naming one by one.
+CSIP_RETCODE CSIPsetVarNames(CSIP_MODEL *model, int numindices, int *indices,
+                             const char **names);
+CSIP_RETCODE CSIPsetConsNames(CSIP_MODEL *model, int numindices, int *indices,
+                              const char **names);
+
+// Get the index of a variable or constraint by its name, or -1 if there is none.
+// The lookup table is built on the first call and then kept up to date.
+int CSIPgetVarIndexByName(CSIP_MODEL *model, const char *name);
+int CSIPgetConsIndexByName(CSIP_MODEL *model, const char *name);
+
 // Supply a solution (as a dense array) to be checked at the beginning of the
 // solving process. Partial solutions are also supported: Indicate missing
-// values with NaN.
+// values with NaN. Replaces all previously given initial solutions.
 CSIP_RETCODE CSIPsetInitialSolution(CSIP_MODEL *model, double *values);
 
+// Add another initial solution (as a dense array, NaN for missing values).
+// Unlike CSIPsetInitialSolution, previously given solutions are kept, and all
+// of them are passed to SCIP.
+CSIP_RETCODE CSIPaddInitialSolution(CSIP_MODEL *model, double *values);
+
+// Add a partial initial solution, given only for the variables in indices.
+// An index out of range is an error.
+CSIP_RETCODE CSIPaddInitialSolutionSparse(
+    CSIP_MODEL *model, int numindices, int *indices, double *values);
+
 /* lazy constraint callback functions */
 
 typedef struct SCIP_ConshdlrData CSIP_LAZYDATA;
@@ -254,6 +499,10 @@ typedef CSIP_RETCODE(*CSIP_LAZYCALLBACK)(
 
 // Add a lazy constraint callback to the model.
 // You may use userdata to pass any data.
+// The callback is also called from copies of SCIP, e.g., in sub-MIP heuristics,
+// with the same userdata and a model whose variables are those of the copy.
+// Copies may run concurrently, e.g., in SCIP's concurrent solver, so the
+// callback must be safe to call from several threads with the same userdata.
 CSIP_RETCODE CSIPaddLazyCallback(
     CSIP_MODEL *model, CSIP_LAZYCALLBACK lazycb, void *userdata);
 
@@ -275,9 +524,69 @@ CSIP_RETCODE CSIPheurAddSolution(CSIP_HEURDATA *heurdata, double *values);
 
 // Add a heuristic callback to the model.
 // You may use userdata to pass any data.
+// As for lazy callbacks, it is also called from copies of SCIP, possibly
+// concurrently.
 CSIP_RETCODE CSIPaddHeuristicCallback(
     CSIP_MODEL *model, CSIP_HEURCALLBACK heur, void *userdata);
 
+/* incumbent callback functions */
+
+typedef struct SCIP_EventhdlrData CSIP_INCUMBENTDATA;
+
+// signature for incumbent callbacks, called whenever a new best solution is
+// found during the solving process.
+// must only call `CSIPincumbent*` methods from within callback, passing
+// `incumbentdata`.
+typedef CSIP_RETCODE(*CSIP_INCUMBENTCALLBACK)(
+    CSIP_MODEL *model, CSIP_INCUMBENTDATA *incumbentdata, void *userdata);
+
+// Get the objective value of the new incumbent. Call this function from your
+// incumbent callback.
+double CSIPincumbentGetObjValue(CSIP_INCUMBENTDATA *incumbentdata);
+
+// Copy values of the new incumbent to output array. Call this function from
+// your incumbent callback.
+CSIP_RETCODE CSIPincumbentGetVarValues(
+    CSIP_INCUMBENTDATA *incumbentdata, double *output);
+
+// Copy values of the given variables in the new incumbent to output array,
+// that is, output[i] is the value of the variable with index indices[i].
+CSIP_RETCODE CSIPincumbentGetVarValuesSparse(
+    CSIP_INCUMBENTDATA *incumbentdata, int numindices, int *indices,
+    double *output);
+
+// Add an incumbent callback to the model.
+// You may use userdata to pass any data.
+CSIP_RETCODE CSIPaddIncumbentCallback(
+    CSIP_MODEL *model, CSIP_INCUMBENTCALLBACK incumbentcb, void *userdata);
+
+/* progress callback functions */
+
+// snapshot of the solving process, passed to progress callbacks
+typedef struct
+{
+    double primalbound;      // objective value of best known solution
+    double dualbound;        // best known bound on the optimal solution
+    double gap;              // relative gap between primal and dual bound
+    long long nnodes;        // number of processed nodes
+    int nopennodes;          // number of open nodes
+    long long nlpiterations; // total number of LP iterations
+    double solvingtime;      // elapsed solving time in seconds
+} CSIP_PROGRESS;
+
+// signature for progress callbacks.
+// You may call CSIPinterrupt from within the callback to stop early.
+typedef CSIP_RETCODE(*CSIP_PROGRESSCALLBACK)(
+    CSIP_MODEL *model, CSIP_PROGRESS *progress, void *userdata);
+
+// Add a progress callback to the model. It is called after a node was solved
+// if at least nodefreq nodes were solved or timefreq seconds have passed since
+// the last call. Use values <= 0 to disable either criterion.
+// You may use userdata to pass any data.
+CSIP_RETCODE CSIPaddProgressCallback(
+    CSIP_MODEL *model, int nodefreq, double timefreq,
+    CSIP_PROGRESSCALLBACK progresscb, void *userdata);
+
 /* advanced usage */
 
 // Get access to the internal SCIP solver. Use at your own risk!
@@ -285,5 +594,83 @@ void *CSIPgetInternalSCIP(CSIP_MODEL *model);
 
 /* additional features (on top of SCIP) */
 
+// Write the model to a file in CSIP's own binary format. This preserves the
+// indices of variables and constraints, the objective (also nonlinear) and the
+// objective sense. Callbacks, parameters and initial solutions are not stored.
+// Files are only portable between machines of the same byte order.
+CSIP_RETCODE CSIPwriteModel(CSIP_MODEL *model, const char *filename);
+
+// Create a new model from a file written by CSIPwriteModel. Files that are
+// truncated, corrupt or of another version give CSIP_RETCODE_ERROR; then
+// *model is set to NULL.
+CSIP_RETCODE CSIPreadModel(const char *filename, CSIP_MODEL **model);
+
+// Compute a hash of the model data: variables, objective and constraints, in
+// the order they were added, but not parameters or callbacks. The hash is kept
+// until the model changes.
+CSIP_RETCODE CSIPgetFingerprint(
+    CSIP_MODEL *model, unsigned long long *fingerprint);
+
+// Create a cache of solutions for at most capacity models, which can be shared
+// by several models. The cache must outlive all models that use it. It is not
+// thread-safe: models sharing a cache must not be solved concurrently.
+CSIP_RETCODE CSIPcreateCache(CSIP_CACHE **cache, int capacity);
+
+// Free a cache.
+CSIP_RETCODE CSIPfreeCache(CSIP_CACHE *cache);
+
+// Use a cache (or none, if NULL) when solving the model. When the fingerprint
+// matches that of a model solved before, its best solution is used as initial
+// solution, unless one is given by CSIPsetInitialSolution. After solving, the
+// best solution is stored if it is better than the stored one, replacing the
+// least recently used entry if needed.
+CSIP_RETCODE CSIPsetCache(CSIP_MODEL *model, CSIP_CACHE *cache);
+
+// Read a linear (integer) program from an MPS file in free format, so names must
+// not contain spaces, and add its variables and constraints to the model. They are appended in the
+// order of the columns and rows in the file, starting at the current number of
+// variables and constraints. Integer columns without bounds have bounds
+// [0, INFINITY]. Objective offsets and sections other than NAME, OBJSENSE,
+// ROWS, COLUMNS, RHS, RANGES and BOUNDS are not supported.
+CSIP_RETCODE CSIPreadMPS(CSIP_MODEL *model, const char *filename);
+
+// Write the problem to a file in one of the formats supported by SCIP, given by
+// its extension, e.g., "lp", "mps" or "cip". Variables and constraints without
+// a name are written as x<i> and c<i>, see CSIPsetVarName; after deletions, i
+// counts the deleted ones as well and is no longer the index in CSIP. A
+// nonlinear objective is written as a variable "objvar" and an additional
+// constraint.
+CSIP_RETCODE CSIPwriteProblem(CSIP_MODEL *model, const char *filename,
+                              const char *format);
+
 // Set a prefix for all messages.
 CSIP_RETCODE CSIPsetMessagePrefix(CSIP_MODEL *model, const char* prefix);
+
+// Set a prefix for all messages, like CSIPsetMessagePrefix, but collect the
+// output line by line in a buffer of buffersize bytes. The buffer is written
+// when it is full, at the end of each solve and when the model is freed.
+CSIP_RETCODE CSIPsetBufferedMessagePrefix(
+    CSIP_MODEL *model, const char* prefix, int buffersize);
+
+// signature for log callbacks. msg is a single line of output and is only
+// valid during the call.
+typedef void(*CSIP_LOGCALLBACK)(
+    CSIP_MODEL *model, CSIP_MSGTYPE msgtype, const char *msg, void *userdata);
+
+// Pass all messages to a log callback instead of writing them to a file.
+// verblevel sets SCIP's verbosity level (0: none, ..., 5: full), see the
+// parameter "display/verblevel". This replaces any message prefix.
+// You may use userdata to pass any data.
+CSIP_RETCODE CSIPsetLogCallback(
+    CSIP_MODEL *model, CSIP_LOGCALLBACK logcb, void *userdata, int verblevel);
+
+// Enable (or disable) timing of the phases within lazy and heuristic
+// callbacks. Timing is off by default. This also resets all counters.
+CSIP_RETCODE CSIPsetCallbackTiming(CSIP_MODEL *model, int enable);
+
+// Get number of calls and total (wall clock) time in seconds of a phase.
+CSIP_RETCODE CSIPgetCallbackTiming(
+    CSIP_MODEL *model, CSIP_PHASE phase, long long *ncalls, double *totaltime);
+
+// Write the timing of all phases as JSON to a file.
+CSIP_RETCODE CSIPwriteCallbackTiming(CSIP_MODEL *model, const char *filename);
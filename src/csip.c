@@ -1,9 +1,22 @@
+// needed for clock_gettime and mmap
+#define _POSIX_C_SOURCE 200112L
+
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "csip.h"
 #include "nlpi/pub_expr.h"
 #include "scip/scip.h"
 #include "scip/pub_misc.h"
+#include "scip/pub_nlp.h"
 #include "scip/pub_var.h"
 #include "scip/scipdefplugins.h"
 
@@ -68,6 +81,178 @@ static inline int retCodeCSIPtoSCIP(int csipRetCode)
 #define INITIALSIZE 64
 #define GROWFACTOR   2
 
+// size of the output buffer when writing problems
+#define WRITEBUFFERSIZE (1 << 20)
+
+/* hash table from names to indices, using open addressing with linear probing.
+ * The table does not own the names.
+ */
+typedef struct
+{
+    int size;           // number of slots, a power of two
+    int nentries;
+    const char **names;
+    int *namelens;
+    int *values;
+} CSIP_NAMETABLE;
+
+// FNV-1a hash
+static inline
+unsigned int hashName(const char *name, int len)
+{
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < len; ++i)
+    {
+        hash = (hash ^ (unsigned char) name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static
+CSIP_RETCODE createNameTable(CSIP_NAMETABLE *table, int minsize)
+{
+    table->size = INITIALSIZE;
+    while (table->size < 2 * minsize)
+    {
+        table->size *= 2;
+    }
+    table->nentries = 0;
+    table->names = (const char **) calloc(table->size, sizeof(const char *));
+    table->namelens = (int *) malloc(table->size * sizeof(int));
+    table->values = (int *) malloc(table->size * sizeof(int));
+    if (table->names == NULL || table->namelens == NULL
+            || table->values == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+static
+void freeNameTable(CSIP_NAMETABLE *table)
+{
+    free(table->names);
+    free(table->namelens);
+    free(table->values);
+    table->names = NULL;
+    table->namelens = NULL;
+    table->values = NULL;
+}
+
+// returns the slot of name, or the empty slot where it would be inserted
+static inline
+int findNameSlot(const CSIP_NAMETABLE *table, const char *name, int len)
+{
+    int mask = table->size - 1;
+    int slot = hashName(name, len) & mask;
+
+    while (table->names[slot] != NULL
+            && (table->namelens[slot] != len
+                || memcmp(table->names[slot], name, len) != 0))
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+// returns the value stored for name, or -1 if there is none
+static
+int findName(const CSIP_NAMETABLE *table, const char *name, int len)
+{
+    int slot = findNameSlot(table, name, len);
+    return table->names[slot] == NULL ? -1 : table->values[slot];
+}
+
+// remove a name, moving back the entries of its probe sequence
+static
+void removeName(CSIP_NAMETABLE *table, const char *name, int len)
+{
+    int mask = table->size - 1;
+    int slot = findNameSlot(table, name, len);
+    int next = slot;
+
+    if (table->names[slot] == NULL)
+    {
+        return;
+    }
+
+    while (TRUE)
+    {
+        int home;
+
+        next = (next + 1) & mask;
+        if (table->names[next] == NULL)
+        {
+            break;
+        }
+
+        // move the entry if its home slot is not between slot and next
+        home = hashName(table->names[next], table->namelens[next]) & mask;
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            table->names[slot] = table->names[next];
+            table->namelens[slot] = table->namelens[next];
+            table->values[slot] = table->values[next];
+            slot = next;
+        }
+    }
+
+    table->names[slot] = NULL;
+    --(table->nentries);
+}
+
+// insert (or overwrite) the value for a name; the name must stay valid
+static
+CSIP_RETCODE insertName(CSIP_NAMETABLE *table, const char *name, int len,
+                        int value)
+{
+    int slot;
+
+    // keep the load factor below 1/2
+    if (2 * (table->nentries + 1) > table->size)
+    {
+        CSIP_NAMETABLE newtable;
+
+        CSIP_CALL(createNameTable(&newtable, table->size));
+        for (int i = 0; i < table->size; ++i)
+        {
+            if (table->names[i] != NULL)
+            {
+                slot = findNameSlot(&newtable, table->names[i],
+                                    table->namelens[i]);
+                newtable.names[slot] = table->names[i];
+                newtable.namelens[slot] = table->namelens[i];
+                newtable.values[slot] = table->values[i];
+            }
+        }
+        newtable.nentries = table->nentries;
+        freeNameTable(table);
+        *table = newtable;
+    }
+
+    slot = findNameSlot(table, name, len);
+    if (table->names[slot] == NULL)
+    {
+        table->names[slot] = name;
+        table->namelens[slot] = len;
+        ++(table->nentries);
+    }
+    table->values[slot] = value;
+
+    return CSIP_RETCODE_OK;
+}
+
+// named set of constraints, given by their indices, toggled together
+typedef struct
+{
+    char *name;
+    int nconss;
+    int consssize;
+    int *conss;
+} CSIP_CONSGROUP;
+
 struct csip_model
 {
     SCIP *scip;
@@ -77,53 +262,226 @@ struct csip_model
     int varssize;
     SCIP_VAR **vars;
 
-    // variable sized array for constraints
+    // variable sized array for constraints, and whether each is active; inactive
+    // constraints are not in the problem, see CSIPsetConsActive
     int nconss;
     int consssize;
     SCIP_CONS **conss;
+    SCIP_Bool *consactive;
+
+    // number of deleted variables and constraints, to keep default names unique
+    int ndelvars;
+    int ndelconss;
+
+    // whether the transformed problem has fixings of CSIPsolveWithFixings
+    SCIP_Bool tempfixings;
+
+    // variable sized array of constraint groups
+    int ngroups;
+    int groupssize;
+    CSIP_CONSGROUP *groups;
 
     // counter for callbacks
     int nlazycb;
     int nheur;
+    int neventhdlr;
 
-    // user-defined solution, is checked before solving
-    SCIP_SOL *initialsol;
+    // variable sized array of user-defined solutions, checked before solving
+    int ninitialsols;
+    int initialsolssize;
+    SCIP_SOL **initialsols;
 
     // store objective variable for nonlinear objective: the idea is to add an
     // auxiliary constraint and variable to represent nonlinear objectives. If
-    // the objective gets change, we set to 0 the objective coefficient of this
-    // variable and relax its bounds so the auxiliary constraint is redundant.
-    // This is going to mess the model when printed to a file.
+    // the objective gets changed, both are deleted from the problem.
     SCIP_VAR *objvar;
     SCIP_CONS *objcons;
     CSIP_OBJTYPE objtype;
 
+    // last point at which objvar was evaluated for an initial solution, given
+    // by the values of the variables of the objective's expression tree
+    double *objpoint;
+    double objpointval;
+    SCIP_Bool hasobjpoint;
+
     // store message handler to allow for a prefix
     SCIP_MESSAGEHDLR* msghdlr;
+
+    // statistics of the lazy and heuristic callbacks in the last solve
+    SCIP_Longint nlazycalls;
+    SCIP_CLOCK *lazyclock;
+    SCIP_Longint nheurcalls;
+    SCIP_CLOCK *heurclock;
+
+    // opt-in timing of the phases within lazy and heuristic callbacks
+    SCIP_Bool timing;
+    SCIP_Longint phasecalls[CSIP_NPHASES];
+    double phasetime[CSIP_NPHASES];
+
+    // per-plugin statistics handed out by CSIPgetSolveStats
+    const char **sepanames;
+    long long *sepancuts;
+    const char **heurnames;
+    double *heurtimes;
+
+    // lookup of variables and constraints by name, built on first use; the
+    // names are owned by SCIP
+    CSIP_NAMETABLE varnames;
+    CSIP_NAMETABLE consnames;
+
+    // solutions of models with the same fingerprint, shared between models
+    CSIP_CACHE *cache;
+
+    // fingerprint of the model, if computed since its last change
+    SCIP_Bool hasfingerprint;
+    unsigned long long fingerprint;
 };
 
 /*
  * local methods
  */
 
+// names of the timed phases, used for the JSON output
+static const char *phasenames[CSIP_NPHASES] =
+{
+    "lazy_callback",
+    "lazy_getvarvalues",
+    "lazy_createcons",
+    "lazy_checkcons",
+    "lazy_addcons",
+    "heur_callback",
+    "heur_getvarvalues",
+    "heur_addsolution"
+};
+
+static inline
+double wallClock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+// start timing a phase; returns 0 if timing is disabled
+static inline
+double startPhase(CSIP_MODEL *model)
+{
+    return model->timing ? wallClock() : 0.0;
+}
+
+static inline
+void stopPhase(CSIP_MODEL *model, CSIP_PHASE phase, double start)
+{
+    if (model->timing)
+    {
+        model->phasecalls[phase] += 1;
+        model->phasetime[phase] += wallClock() - start;
+    }
+}
+
+// defined with the message handler below
+static void flushMessages(CSIP_MODEL *model);
+
+// defined with the solution cache below
+static CSIP_RETCODE useCachedSolution(CSIP_MODEL *model,
+                                      unsigned long long fingerprint);
+static CSIP_RETCODE storeCachedSolution(CSIP_MODEL *model,
+                                        unsigned long long fingerprint);
+
+// defined with the model constraint handler below
+static CSIP_RETCODE addModelCons(CSIP_MODEL *model);
+
 static
-CSIP_RETCODE createLinCons(CSIP_MODEL *model, int numindices, int *indices,
+CSIP_RETCODE createLinCons(CSIP_MODEL *model, const char *name,
+                           int numindices, int *indices,
                            double *coefs, double lhs, double rhs, SCIP_CONS **cons)
 {
     SCIP *scip;
-    SCIP_VAR *var;
+    SCIP_VAR **vars;
     int i;
 
     scip = model->scip;
 
-    SCIP_in_CSIP(SCIPcreateConsBasicLinear(scip, cons, "lincons", 0, NULL, NULL,
-                                           lhs, rhs));
-
+    // create the constraint with all coefficients at once
+    vars = (SCIP_VAR **) malloc(numindices * sizeof(SCIP_VAR *));
+    if (numindices > 0 && vars == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
     for (i = 0; i < numindices; ++i)
     {
-        var = model->vars[indices[i]];
-        SCIP_in_CSIP(SCIPaddCoefLinear(scip, *cons, var, coefs[i]));
+        vars[i] = model->vars[indices[i]];
+    }
+
+    SCIP_in_CSIP(SCIPcreateConsBasicLinear(scip, cons, name, numindices,
+                                           vars, coefs, lhs, rhs));
+    free(vars);
+
+    return CSIP_RETCODE_OK;
+}
+
+/* constraints and variables are named by their index in CSIP, so that written
+ * problems can be mapped back to the model; after deletions, by the number of
+ * constraints and variables added so far */
+static
+void consName(CSIP_MODEL *model, char *name)
+{
+    (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "c%d",
+                        model->nconss + model->ndelconss);
+}
+
+/* free the transformed problem before changing the model, which also makes
+ * the fingerprint stale; freeing it for other reasons keeps the fingerprint
+ */
+static
+CSIP_RETCODE freeTransform(CSIP_MODEL *model)
+{
+    SCIP_in_CSIP(SCIPfreeTransform(model->scip));
+    model->hasfingerprint = FALSE;
+
+    return CSIP_RETCODE_OK;
+}
+
+// free the initial solutions that were not given to SCIP
+static
+CSIP_RETCODE freeInitialSolutions(CSIP_MODEL *model)
+{
+    for (int i = 0; i < model->ninitialsols; ++i)
+    {
+        SCIP_in_CSIP(SCIPfreeSol(model->scip, &model->initialsols[i]));
+    }
+    model->ninitialsols = 0;
+
+    return CSIP_RETCODE_OK;
+}
+
+/* if a nonlinear objective was set, delete objvar and the objective
+ * constraint from the problem, so that repeated objective changes do not leave
+ * them behind. This needs the problem stage, i.e., call SCIPfreeTransform first.
+ */
+static
+CSIP_RETCODE removeNonlinearObj(CSIP_MODEL *model)
+{
+    SCIP *scip = model->scip;
+    SCIP_Bool deleted;
+
+    if (model->objvar == NULL)
+    {
+        return CSIP_RETCODE_OK;
     }
+    assert(SCIPgetStage(scip) == SCIP_STAGE_PROBLEM);
+    model->hasobjpoint = FALSE;
+
+    // the constraint goes first, it is the only one using objvar
+    SCIP_in_CSIP(SCIPdelCons(scip, model->objcons));
+    SCIP_in_CSIP(SCIPdelVar(scip, model->objvar, &deleted));
+    assert(deleted);
+
+    // we do not need to remember this variable anymore nor the objcons
+    SCIP_in_CSIP(SCIPreleaseVar(scip, &model->objvar));
+    SCIP_in_CSIP(SCIPreleaseCons(scip, &model->objcons));
+    assert(model->objvar == NULL);
+    assert(model->objcons == NULL);
 
     return CSIP_RETCODE_OK;
 }
@@ -143,7 +501,10 @@ CSIP_RETCODE addCons(CSIP_MODEL *model, SCIP_CONS *cons, int *idx)
         model->consssize = GROWFACTOR * model->consssize;
         model->conss = (SCIP_CONS **) realloc(
                            model->conss,  model->consssize * sizeof(SCIP_CONS *));
-        if (model->conss == NULL)
+        model->consactive = (SCIP_Bool *) realloc(
+                                model->consactive,
+                                model->consssize * sizeof(SCIP_Bool));
+        if (model->conss == NULL || model->consactive == NULL)
         {
             return CSIP_RETCODE_NOMEMORY;
         }
@@ -158,109 +519,526 @@ CSIP_RETCODE addCons(CSIP_MODEL *model, SCIP_CONS *cons, int *idx)
     {
         model->conss[model->nconss] = cons;
     }
+    model->consactive[model->nconss] = TRUE;
+
+    if (model->consnames.names != NULL)
+    {
+        const char *name = SCIPconsGetName(cons);
+        CSIP_CALL(insertName(&model->consnames, name, strlen(name),
+                             model->nconss));
+    }
 
     ++(model->nconss);
 
     return CSIP_RETCODE_OK;
 }
 
+// whether idx refers to one of nvalues values; a negative nvalues is unknown
 static
-CSIP_RETCODE createExprtree(
-    CSIP_MODEL *model, int nops, CSIP_OP *ops, int *children, int *begin,
-    double *values, SCIP_EXPRTREE **tree)
+SCIP_Bool isValueIndex(int idx, int nvalues)
 {
-    SCIP *scip;
-    SCIP_EXPR **exprs;
-    SCIP_VAR **vars;
-    int varpos;
-    int i;
-    int nvars;
+    return idx >= 0 && (nvalues < 0 || idx < nvalues);
+}
 
-    scip = model->scip;
-    exprs = (SCIP_EXPR **) malloc(nops * sizeof(SCIP_EXPR *));
-    nvars = 0;
-    for (i = 0; i < nops; ++i)
+/* whether the nchildren entries in children form a LINEAR, QUADRATIC or
+ * POLYNOMIAL operator at position opidx, see CSIPaddNonLinCons for the format
+ */
+static
+SCIP_Bool isValidNaryExpr(CSIP_OP op, const int *children, int nchildren,
+                          int opidx, int nvalues)
+{
+    int nexprs;
+    int pos;
+
+    if (op == SCIP_EXPR_LINEAR)
     {
-        exprs[i] = NULL;
-        nvars += (ops[i] == SCIP_EXPR_VARIDX);
+        if (nchildren < 1 || nchildren % 2 == 0)
+        {
+            return FALSE;
+        }
+        nexprs = (nchildren - 1) / 2;
+        pos = 0;
+    }
+    else
+    {
+        if (nchildren < 2 || children[0] < 0 || children[0] > nchildren - 2)
+        {
+            return FALSE;
+        }
+        nexprs = children[0];
+        pos = 1;
     }
-    vars = (SCIP_VAR **) malloc(nvars * sizeof(SCIP_VAR *));
 
-    varpos = 0;
-    for (i = 0; i < nops; ++i)
+    // the children ops come before this one, the values come after them
+    for (int c = pos; c < pos + nexprs; ++c)
     {
-        switch (ops[i])
+        if (children[c] < 0 || children[c] >= opidx)
         {
-        case SCIP_EXPR_VARIDX:
+            return FALSE;
+        }
+    }
+    pos += nexprs;
+
+    if (op == SCIP_EXPR_LINEAR)
+    {
+        for (int c = pos; c < nchildren; ++c)
+        {
+            if (!isValueIndex(children[c], nvalues))
             {
-                int varidx = children[begin[i]];
-                assert(1 == begin[i + 1] - begin[i]);
-                assert(varidx < model->nvars);
-                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
-                                            ops[i], varpos));
-                vars[varpos] = model->vars[varidx];
-                ++varpos;
-                //printf("Seeing variable %d (nchild %d)\n", varidx, begin[i+1] - begin[i]);
+                return FALSE;
             }
-            break;
-        case SCIP_EXPR_CONST:
-            assert(1 == begin[i + 1] - begin[i]);
-            SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
-                                        ops[i], values[children[begin[i]]]));
-            //printf("Seeing constant %g (nchild %d)\n", values[children[begin[i]]], begin[i+1] - begin[i]);
-            break;
-        case SCIP_EXPR_MINUS:
-            // if we have two children it is a proper minus; otherwise just -1 * ...
-            if (begin[i + 1] - begin[i] == 2)
+        }
+    }
+    else if (op == SCIP_EXPR_QUADRATIC)
+    {
+        if (nchildren < pos + nexprs + 1
+                || (nchildren - pos - nexprs - 1) % 3 != 0)
+        {
+            return FALSE;
+        }
+        for (int c = pos; c < pos + nexprs + 1; ++c)
+        {
+            if (!isValueIndex(children[c], nvalues))
             {
-                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
-                                            ops[i], exprs[children[begin[i]]], exprs[children[begin[i] + 1]]));
+                return FALSE;
             }
-            else
+        }
+        for (int q = pos + nexprs + 1; q < nchildren; q += 3)
+        {
+            if (children[q] < 0 || children[q] >= nexprs
+                    || children[q + 1] < 0 || children[q + 1] >= nexprs
+                    || !isValueIndex(children[q + 2], nvalues))
             {
-                SCIP_EXPR *zeroexpr;
-                assert(1 == begin[i + 1] - begin[i]);
-                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &zeroexpr,
-                                            SCIP_EXPR_CONST, 0.0));
-                // expression is 0 - child
-                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
-                                            ops[i], zeroexpr, exprs[children[begin[i]]]));
+                return FALSE;
             }
-            //printf("Seeing a minus (nchild %d)\n",  begin[i+1] - begin[i]);
-            break;
-        case SCIP_EXPR_REALPOWER:
-            assert(2 == begin[i + 1] - begin[i]);
+        }
+    }
+    else
+    {
+        if (!isValueIndex(children[pos], nvalues))
+        {
+            return FALSE;
+        }
+        ++pos;
+        while (pos < nchildren)
+        {
+            int nfactors = children[pos];
+
+            if (nfactors < 0 || pos + 2 + 2 * nfactors > nchildren
+                    || !isValueIndex(children[pos + 1], nvalues))
             {
-                double exponent;
-                // the second child is the exponent which is a const
-                exponent = values[children[begin[children[begin[i] + 1]]]];
-                //printf("Seeing a power with exponent %g (nchild %d)\n", exponent, begin[i+1] - begin[i]);
-                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
-                                            ops[i], exprs[children[begin[i]]], exponent));
+                return FALSE;
             }
-            break;
-        case SCIP_EXPR_DIV:
-            assert(2 == begin[i + 1] - begin[i]);
-            SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
-                                        ops[i], exprs[children[begin[i]]], exprs[children[begin[i] + 1]]));
-            //printf("Seeing a division (nchild %d)\n",  begin[i+1] - begin[i]);
-            break;
-        case SCIP_EXPR_SQRT:
-        case SCIP_EXPR_EXP:
-        case SCIP_EXPR_LOG:
-            assert(1 == begin[i + 1] - begin[i]);
-            SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
-                                        ops[i], exprs[children[begin[i]]]));
-            //printf("Seeing a sqrt/exp/log (nchild %d)\n",  begin[i+1] - begin[i]);
-            break;
-        case SCIP_EXPR_SUM:
-        case SCIP_EXPR_PRODUCT:
+            pos += 2;
+            for (int f = 0; f < nfactors; ++f)
             {
-                SCIP_EXPR **childrenexpr;
-                int nchildren = begin[i + 1] - begin[i];
-                int c;
-                childrenexpr = (SCIP_EXPR **) malloc(nchildren * sizeof(SCIP_EXPR *));
-                for (c = 0; c < nchildren; ++c)
+                if (children[pos + 2 * f] < 0
+                        || children[pos + 2 * f] >= nexprs
+                        || !isValueIndex(children[pos + 2 * f + 1], nvalues))
+                {
+                    return FALSE;
+                }
+            }
+            pos += 2 * nfactors;
+        }
+    }
+
+    return TRUE;
+}
+
+/* create a LINEAR, QUADRATIC or POLYNOMIAL expression from its nchildren
+ * entries in children, see CSIPaddNonLinCons for the format; exprs holds the
+ * expressions of the previous operators, of which there are opidx */
+static
+CSIP_RETCODE createNaryExpr(SCIP *scip, CSIP_OP op, const int *children,
+                            int nchildren, int opidx, const double *values,
+                            SCIP_EXPR **exprs, SCIP_EXPR **expr)
+{
+    SCIP_EXPR **childexprs;
+    double *coefs;
+    int nexprs;
+    int pos;
+
+    if (!isValidNaryExpr(op, children, nchildren, opidx, -1))
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    // children of LINEAR are followed by the coefficients and the constant
+    nexprs = (op == SCIP_EXPR_LINEAR) ? (nchildren - 1) / 2 : children[0];
+    pos = (op == SCIP_EXPR_LINEAR) ? 0 : 1;
+
+    childexprs = (SCIP_EXPR **) malloc(MAX(nexprs, 1) * sizeof(SCIP_EXPR *));
+    coefs = (double *) malloc(MAX(nexprs, 1) * sizeof(double));
+    if (childexprs == NULL || coefs == NULL)
+    {
+        free(coefs);
+        free(childexprs);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    for (int c = 0; c < nexprs; ++c)
+    {
+        childexprs[c] = exprs[children[pos + c]];
+    }
+    pos += nexprs;
+
+    if (op == SCIP_EXPR_LINEAR)
+    {
+        assert(nchildren == 2 * nexprs + 1);
+        for (int c = 0; c < nexprs; ++c)
+        {
+            coefs[c] = values[children[pos + c]];
+        }
+        SCIP_in_CSIP(SCIPexprCreateLinear(SCIPblkmem(scip), expr, nexprs,
+                                          childexprs, coefs,
+                                          values[children[pos + nexprs]]));
+    }
+    else if (op == SCIP_EXPR_QUADRATIC)
+    {
+        double constant = values[children[pos]];
+        int nquadelems = (nchildren - 2 * nexprs - 2) / 3;
+        SCIP_QUADELEM *quadelems;
+
+        for (int c = 0; c < nexprs; ++c)
+        {
+            coefs[c] = values[children[pos + 1 + c]];
+        }
+        pos += nexprs + 1;
+
+        quadelems = (SCIP_QUADELEM *) malloc(MAX(nquadelems, 1)
+                                             * sizeof(SCIP_QUADELEM));
+        if (quadelems == NULL)
+        {
+            free(coefs);
+            free(childexprs);
+            return CSIP_RETCODE_NOMEMORY;
+        }
+        for (int q = 0; q < nquadelems; ++q)
+        {
+            // SCIP expects idx1 <= idx2
+            quadelems[q].idx1 = MIN(children[pos + 3 * q],
+                                    children[pos + 3 * q + 1]);
+            quadelems[q].idx2 = MAX(children[pos + 3 * q],
+                                    children[pos + 3 * q + 1]);
+            quadelems[q].coef = values[children[pos + 3 * q + 2]];
+        }
+
+        SCIP_in_CSIP(SCIPexprCreateQuadratic(SCIPblkmem(scip), expr, nexprs,
+                                             childexprs, constant, coefs,
+                                             nquadelems, quadelems));
+        free(quadelems);
+    }
+    else
+    {
+        SCIP_EXPRDATA_MONOMIAL **monomials;
+        int *childidxs;
+        double *exponents;
+        double constant = values[children[pos]];
+        int nmonomials = 0;
+        int maxentries;
+
+        assert(op == SCIP_EXPR_POLYNOMIAL);
+        ++pos;
+
+        // each monomial takes two entries and two per factor
+        maxentries = MAX((nchildren - pos) / 2, 1);
+        monomials = (SCIP_EXPRDATA_MONOMIAL **) malloc(
+                        maxentries * sizeof(SCIP_EXPRDATA_MONOMIAL *));
+        childidxs = (int *) malloc(maxentries * sizeof(int));
+        exponents = (double *) malloc(maxentries * sizeof(double));
+        if (monomials == NULL || childidxs == NULL || exponents == NULL)
+        {
+            free(exponents);
+            free(childidxs);
+            free(monomials);
+            free(coefs);
+            free(childexprs);
+            return CSIP_RETCODE_NOMEMORY;
+        }
+        while (pos < nchildren)
+        {
+            int nfactors = children[pos];
+            double coef = values[children[pos + 1]];
+
+            pos += 2;
+            for (int f = 0; f < nfactors; ++f)
+            {
+                childidxs[f] = children[pos + 2 * f];
+                exponents[f] = values[children[pos + 2 * f + 1]];
+            }
+            pos += 2 * nfactors;
+
+            SCIP_in_CSIP(SCIPexprCreateMonomial(SCIPblkmem(scip),
+                                                &monomials[nmonomials], coef,
+                                                nfactors, childidxs, exponents));
+            ++nmonomials;
+        }
+        assert(pos == nchildren);
+
+        // the polynomial takes over the monomials
+        SCIP_in_CSIP(SCIPexprCreatePolynomial(SCIPblkmem(scip), expr, nexprs,
+                                              childexprs, nmonomials, monomials,
+                                              constant, FALSE));
+        free(exponents);
+        free(childidxs);
+        free(monomials);
+    }
+
+    free(coefs);
+    free(childexprs);
+
+    return CSIP_RETCODE_OK;
+}
+
+// whether all n children are operators before the one at position opidx
+static
+SCIP_Bool childrenBefore(const int *children, int n, int opidx)
+{
+    for (int c = 0; c < n; ++c)
+    {
+        if (children[c] < 0 || children[c] >= opidx)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* whether the operators form an expression of the format of CSIPaddNonLinCons,
+ * checked before any expression is created; the length of values is only
+ * known for expressions read from files, otherwise nvalues is -1
+ */
+static
+SCIP_Bool isValidExpr(int nvars, int nops, CSIP_OP *ops, int *children,
+                      int *begin, double *values, int nvalues)
+{
+    if (nops < 1 || begin[0] < 0)
+    {
+        return FALSE;
+    }
+
+    for (int i = 0; i < nops; ++i)
+    {
+        const int *opchildren = &children[begin[i]];
+        int n = begin[i + 1] - begin[i];
+
+        if (n < 0)
+        {
+            return FALSE;
+        }
+        switch (ops[i])
+        {
+        case SCIP_EXPR_VARIDX:
+            if (n != 1 || opchildren[0] < 0 || opchildren[0] >= nvars)
+            {
+                return FALSE;
+            }
+            break;
+        case SCIP_EXPR_CONST:
+            if (n != 1 || !isValueIndex(opchildren[0], nvalues))
+            {
+                return FALSE;
+            }
+            break;
+        case SCIP_EXPR_MINUS:
+            if ((n != 1 && n != 2) || !childrenBefore(opchildren, n, i))
+            {
+                return FALSE;
+            }
+            break;
+        case SCIP_EXPR_REALPOWER:
+        case SCIP_EXPR_INTPOWER:
+            // the exponent is given by a CONST
+            if (n != 2 || !childrenBefore(opchildren, n, i)
+                    || ops[opchildren[1]] != SCIP_EXPR_CONST)
+            {
+                return FALSE;
+            }
+            if (ops[i] == SCIP_EXPR_INTPOWER)
+            {
+                double exponent = values[children[begin[opchildren[1]]]];
+
+                if (exponent != floor(exponent) || fabs(exponent) > INT_MAX)
+                {
+                    return FALSE;
+                }
+            }
+            break;
+        case SCIP_EXPR_DIV:
+        case SCIP_EXPR_MIN:
+        case SCIP_EXPR_MAX:
+            if (n != 2 || !childrenBefore(opchildren, n, i))
+            {
+                return FALSE;
+            }
+            break;
+        case SCIP_EXPR_SQUARE:
+        case SCIP_EXPR_SQRT:
+        case SCIP_EXPR_EXP:
+        case SCIP_EXPR_LOG:
+        case SCIP_EXPR_SIN:
+        case SCIP_EXPR_COS:
+        case SCIP_EXPR_ABS:
+            if (n != 1 || !childrenBefore(opchildren, n, i))
+            {
+                return FALSE;
+            }
+            break;
+        case SCIP_EXPR_LINEAR:
+        case SCIP_EXPR_QUADRATIC:
+        case SCIP_EXPR_POLYNOMIAL:
+            if (!isValidNaryExpr(ops[i], opchildren, n, i, nvalues))
+            {
+                return FALSE;
+            }
+            break;
+        case SCIP_EXPR_SUM:
+        case SCIP_EXPR_PRODUCT:
+            if (!childrenBefore(opchildren, n, i))
+            {
+                return FALSE;
+            }
+            break;
+        default:
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static
+CSIP_RETCODE createExprtree(
+    CSIP_MODEL *model, int nops, CSIP_OP *ops, int *children, int *begin,
+    double *values, SCIP_EXPRTREE **tree)
+{
+    SCIP *scip;
+    SCIP_EXPR **exprs;
+    SCIP_VAR **vars;
+    int varpos;
+    int i;
+    int nvars;
+
+    // reject invalid input before creating anything
+    if (!isValidExpr(model->nvars, nops, ops, children, begin, values, -1))
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    scip = model->scip;
+    exprs = (SCIP_EXPR **) malloc(nops * sizeof(SCIP_EXPR *));
+    nvars = 0;
+    for (i = 0; exprs != NULL && i < nops; ++i)
+    {
+        exprs[i] = NULL;
+        nvars += (ops[i] == SCIP_EXPR_VARIDX);
+    }
+    vars = (SCIP_VAR **) malloc(MAX(nvars, 1) * sizeof(SCIP_VAR *));
+    if (exprs == NULL || vars == NULL)
+    {
+        free(vars);
+        free(exprs);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    varpos = 0;
+    for (i = 0; i < nops; ++i)
+    {
+        switch (ops[i])
+        {
+        case SCIP_EXPR_VARIDX:
+            {
+                int varidx = children[begin[i]];
+                assert(1 == begin[i + 1] - begin[i]);
+                assert(varidx < model->nvars);
+                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
+                                            ops[i], varpos));
+                vars[varpos] = model->vars[varidx];
+                ++varpos;
+                //printf("Seeing variable %d (nchild %d)\n", varidx, begin[i+1] - begin[i]);
+            }
+            break;
+        case SCIP_EXPR_CONST:
+            assert(1 == begin[i + 1] - begin[i]);
+            SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
+                                        ops[i], values[children[begin[i]]]));
+            //printf("Seeing constant %g (nchild %d)\n", values[children[begin[i]]], begin[i+1] - begin[i]);
+            break;
+        case SCIP_EXPR_MINUS:
+            // if we have two children it is a proper minus; otherwise just -1 * ...
+            if (begin[i + 1] - begin[i] == 2)
+            {
+                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
+                                            ops[i], exprs[children[begin[i]]], exprs[children[begin[i] + 1]]));
+            }
+            else
+            {
+                SCIP_EXPR *zeroexpr;
+                assert(1 == begin[i + 1] - begin[i]);
+                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &zeroexpr,
+                                            SCIP_EXPR_CONST, 0.0));
+                // expression is 0 - child
+                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
+                                            ops[i], zeroexpr, exprs[children[begin[i]]]));
+            }
+            //printf("Seeing a minus (nchild %d)\n",  begin[i+1] - begin[i]);
+            break;
+        case SCIP_EXPR_REALPOWER:
+            assert(2 == begin[i + 1] - begin[i]);
+            {
+                double exponent;
+                // the second child is the exponent which is a const
+                exponent = values[children[begin[children[begin[i] + 1]]]];
+                //printf("Seeing a power with exponent %g (nchild %d)\n", exponent, begin[i+1] - begin[i]);
+                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
+                                            ops[i], exprs[children[begin[i]]], exponent));
+            }
+            break;
+        case SCIP_EXPR_INTPOWER:
+            assert(2 == begin[i + 1] - begin[i]);
+            {
+                // the second child is the exponent, an integral const
+                int exponent = (int) values[children[begin[children[begin[i] + 1]]]];
+                SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
+                                            ops[i], exprs[children[begin[i]]], exponent));
+            }
+            break;
+        case SCIP_EXPR_DIV:
+        case SCIP_EXPR_MIN:
+        case SCIP_EXPR_MAX:
+            assert(2 == begin[i + 1] - begin[i]);
+            SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
+                                        ops[i], exprs[children[begin[i]]], exprs[children[begin[i] + 1]]));
+            //printf("Seeing a division (nchild %d)\n",  begin[i+1] - begin[i]);
+            break;
+        case SCIP_EXPR_SQUARE:
+        case SCIP_EXPR_SQRT:
+        case SCIP_EXPR_EXP:
+        case SCIP_EXPR_LOG:
+        case SCIP_EXPR_SIN:
+        case SCIP_EXPR_COS:
+        case SCIP_EXPR_ABS:
+            assert(1 == begin[i + 1] - begin[i]);
+            SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
+                                        ops[i], exprs[children[begin[i]]]));
+            //printf("Seeing a sqrt/exp/log (nchild %d)\n",  begin[i+1] - begin[i]);
+            break;
+        case SCIP_EXPR_LINEAR:
+        case SCIP_EXPR_QUADRATIC:
+        case SCIP_EXPR_POLYNOMIAL:
+            CSIP_CALL(createNaryExpr(scip, ops[i], &children[begin[i]],
+                                     begin[i + 1] - begin[i], i, values, exprs,
+                                     &exprs[i]));
+            break;
+        case SCIP_EXPR_SUM:
+        case SCIP_EXPR_PRODUCT:
+            {
+                SCIP_EXPR **childrenexpr;
+                int nchildren = begin[i + 1] - begin[i];
+                int c;
+                childrenexpr = (SCIP_EXPR **) malloc(nchildren * sizeof(SCIP_EXPR *));
+                for (c = 0; c < nchildren; ++c)
                 {
                     childrenexpr[c] = exprs[children[begin[i] + c]];
                 }
@@ -268,1422 +1046,7106 @@ CSIP_RETCODE createExprtree(
                 SCIP_in_CSIP(SCIPexprCreate(SCIPblkmem(scip), &exprs[i],
                                             ops[i], nchildren, childrenexpr));
 
-                free(childrenexpr);
-                //printf("Seeing a sum/product (nchild %d)\n",  begin[i+1] - begin[i]);
-            }
-            break;
-        default: // don't support
-            printf("I don't know what I am seeing %d\n",  ops[i]);
-            return CSIP_RETCODE_ERROR;
+                free(childrenexpr);
+                //printf("Seeing a sum/product (nchild %d)\n",  begin[i+1] - begin[i]);
+            }
+            break;
+        default: // don't support
+            printf("I don't know what I am seeing %d\n",  ops[i]);
+            return CSIP_RETCODE_ERROR;
+        }
+    }
+    assert(varpos == nvars);
+    // last expression is root
+    assert(exprs[nops - 1] != NULL);
+    SCIP_in_CSIP(SCIPexprtreeCreate(SCIPblkmem(scip), tree, exprs[nops - 1], nvars,
+                                    0, NULL));
+
+    // assign variables to tree
+    SCIP_in_CSIP(SCIPexprtreeSetVars(*tree, nvars, vars));
+
+    // free memory
+    free(vars);
+    free(exprs);
+
+    return CSIP_RETCODE_OK;
+}
+
+static
+char *strDup(const char *s) {
+    size_t size = strlen(s) + 1;
+    char *p = malloc(size);
+    if (p)
+    {
+        memcpy(p, s, size);
+    }
+    return p;
+}
+
+/* variable sized operator tape, as used in the input of CSIPaddNonLinCons */
+typedef struct
+{
+    int nops;
+    int opssize;
+    CSIP_OP *ops;
+    int *begin;
+    int nchildren;
+    int childrensize;
+    int *children;
+    int nvalues;
+    int valuessize;
+    double *values;
+} CSIP_TAPE;
+
+static
+CSIP_RETCODE createTape(CSIP_TAPE *tape)
+{
+    tape->nops = 0;
+    tape->opssize = INITIALSIZE;
+    tape->ops = (CSIP_OP *) malloc(INITIALSIZE * sizeof(CSIP_OP));
+    tape->begin = (int *) malloc((INITIALSIZE + 1) * sizeof(int));
+    tape->nchildren = 0;
+    tape->childrensize = INITIALSIZE;
+    tape->children = (int *) malloc(INITIALSIZE * sizeof(int));
+    tape->nvalues = 0;
+    tape->valuessize = INITIALSIZE;
+    tape->values = (double *) malloc(INITIALSIZE * sizeof(double));
+    if (tape->ops == NULL || tape->begin == NULL || tape->children == NULL
+            || tape->values == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    tape->begin[0] = 0;
+
+    return CSIP_RETCODE_OK;
+}
+
+static
+void freeTape(CSIP_TAPE *tape)
+{
+    free(tape->ops);
+    free(tape->begin);
+    free(tape->children);
+    free(tape->values);
+}
+
+// append an operator with its children; its index is assigned to opidx
+static
+CSIP_RETCODE appendTapeOp(CSIP_TAPE *tape, CSIP_OP op, int nchildren,
+                          const int *children, int *opidx)
+{
+    // do we need to resize?
+    if (tape->nops >= tape->opssize)
+    {
+        tape->opssize = GROWFACTOR * tape->opssize;
+        tape->ops = (CSIP_OP *) realloc(
+                        tape->ops, tape->opssize * sizeof(CSIP_OP));
+        tape->begin = (int *) realloc(
+                          tape->begin, (tape->opssize + 1) * sizeof(int));
+        if (tape->ops == NULL || tape->begin == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+    }
+    while (tape->nchildren + nchildren > tape->childrensize)
+    {
+        tape->childrensize = GROWFACTOR * tape->childrensize;
+        tape->children = (int *) realloc(
+                             tape->children, tape->childrensize * sizeof(int));
+        if (tape->children == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+    }
+
+    memcpy(tape->children + tape->nchildren, children, nchildren * sizeof(int));
+    tape->nchildren += nchildren;
+
+    *opidx = tape->nops;
+    tape->ops[tape->nops] = op;
+    ++(tape->nops);
+    tape->begin[tape->nops] = tape->nchildren;
+
+    return CSIP_RETCODE_OK;
+}
+
+// append a value; its index is assigned to validx
+static
+CSIP_RETCODE appendTapeValue(CSIP_TAPE *tape, double value, int *validx)
+{
+    if (tape->nvalues >= tape->valuessize)
+    {
+        tape->valuessize = GROWFACTOR * tape->valuessize;
+        tape->values = (double *) realloc(
+                           tape->values, tape->valuessize * sizeof(double));
+        if (tape->values == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+    }
+    tape->values[tape->nvalues] = value;
+    *validx = tape->nvalues;
+    ++(tape->nvalues);
+
+    return CSIP_RETCODE_OK;
+}
+
+// append a CONST operator for the given value
+static
+CSIP_RETCODE appendTapeConst(CSIP_TAPE *tape, double value, int *opidx)
+{
+    int validx;
+
+    CSIP_CALL(appendTapeValue(tape, value, &validx));
+    CSIP_CALL(appendTapeOp(tape, CONST, 1, &validx, opidx));
+
+    return CSIP_RETCODE_OK;
+}
+
+/* append a LINEAR, QUADRATIC or POLYNOMIAL operator, given the operator indices
+ * of its children, in the format of CSIPaddNonLinCons */
+static
+CSIP_RETCODE appendTapeNary(SCIP_EXPR *expr, const int *childops,
+                            CSIP_TAPE *tape, int *opidx)
+{
+    SCIP_EXPROP op = SCIPexprGetOperator(expr);
+    int nexprs = SCIPexprGetNChildren(expr);
+    int nentries;
+    int *entries;
+    int n = 0;
+
+    // upper bound on the number of entries
+    switch (op)
+    {
+    case SCIP_EXPR_LINEAR:
+        nentries = 2 * nexprs + 1;
+        break;
+    case SCIP_EXPR_QUADRATIC:
+        nentries = 2 * nexprs + 2 + 3 * SCIPexprGetNQuadElements(expr);
+        break;
+    default:
+        nentries = nexprs + 2;
+        for (int m = 0; m < SCIPexprGetNMonomials(expr); ++m)
+        {
+            nentries += 2 + 2 * SCIPexprGetMonomialNFactors(
+                            SCIPexprGetMonomials(expr)[m]);
+        }
+        break;
+    }
+
+    entries = (int *) malloc(nentries * sizeof(int));
+    if (entries == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    if (op != SCIP_EXPR_LINEAR)
+    {
+        entries[n++] = nexprs;
+    }
+    for (int c = 0; c < nexprs; ++c)
+    {
+        entries[n++] = childops[c];
+    }
+
+    if (op == SCIP_EXPR_LINEAR)
+    {
+        for (int c = 0; c < nexprs; ++c)
+        {
+            CSIP_CALL(appendTapeValue(tape, SCIPexprGetLinearCoefs(expr)[c],
+                                      &entries[n++]));
+        }
+        CSIP_CALL(appendTapeValue(tape, SCIPexprGetLinearConstant(expr),
+                                  &entries[n++]));
+    }
+    else if (op == SCIP_EXPR_QUADRATIC)
+    {
+        double *lincoefs = SCIPexprGetQuadLinearCoefs(expr);
+        SCIP_QUADELEM *quadelems = SCIPexprGetQuadElements(expr);
+
+        CSIP_CALL(appendTapeValue(tape, SCIPexprGetQuadConstant(expr),
+                                  &entries[n++]));
+        for (int c = 0; c < nexprs; ++c)
+        {
+            CSIP_CALL(appendTapeValue(tape, lincoefs == NULL ? 0.0
+                                      : lincoefs[c], &entries[n++]));
+        }
+        for (int q = 0; q < SCIPexprGetNQuadElements(expr); ++q)
+        {
+            entries[n++] = quadelems[q].idx1;
+            entries[n++] = quadelems[q].idx2;
+            CSIP_CALL(appendTapeValue(tape, quadelems[q].coef, &entries[n++]));
+        }
+    }
+    else
+    {
+        CSIP_CALL(appendTapeValue(tape, SCIPexprGetPolynomialConstant(expr),
+                                  &entries[n++]));
+        for (int m = 0; m < SCIPexprGetNMonomials(expr); ++m)
+        {
+            SCIP_EXPRDATA_MONOMIAL *monomial = SCIPexprGetMonomials(expr)[m];
+            int nfactors = SCIPexprGetMonomialNFactors(monomial);
+
+            entries[n++] = nfactors;
+            CSIP_CALL(appendTapeValue(tape, SCIPexprGetMonomialCoef(monomial),
+                                      &entries[n++]));
+            for (int f = 0; f < nfactors; ++f)
+            {
+                entries[n++] = SCIPexprGetMonomialChildIndices(monomial)[f];
+                CSIP_CALL(appendTapeValue(
+                              tape, SCIPexprGetMonomialExponents(monomial)[f],
+                              &entries[n++]));
+            }
+        }
+    }
+    assert(n == nentries);
+
+    CSIP_CALL(appendTapeOp(tape, op, n, entries, opidx));
+    free(entries);
+
+    return CSIP_RETCODE_OK;
+}
+
+/* Translate an expression (as created by createExprtree) back to a tape.
+ * Children are appended before their parent, so the root ends up last.
+ * varindex maps the problem index of a variable to its CSIP index.
+ */
+static
+CSIP_RETCODE exprToTape(SCIP_EXPR *expr, SCIP_VAR **treevars,
+                        const int *varindex, CSIP_TAPE *tape, int *opidx)
+{
+    SCIP_EXPR **exprchildren = SCIPexprGetChildren(expr);
+    int nchildren = SCIPexprGetNChildren(expr);
+    int *childops;
+    int c;
+
+    switch (SCIPexprGetOperator(expr))
+    {
+    case SCIP_EXPR_VARIDX:
+        {
+            int varidx = varindex[SCIPvarGetProbindex(
+                                      treevars[SCIPexprGetOpIndex(expr)])];
+            CSIP_CALL(appendTapeOp(tape, VARIDX, 1, &varidx, opidx));
+        }
+        break;
+    case SCIP_EXPR_CONST:
+        CSIP_CALL(appendTapeConst(tape, SCIPexprGetOpReal(expr), opidx));
+        break;
+    case SCIP_EXPR_REALPOWER:
+        {
+            int powchildren[2];
+            CSIP_CALL(exprToTape(exprchildren[0], treevars, varindex, tape,
+                                 &powchildren[0]));
+            CSIP_CALL(appendTapeConst(tape, SCIPexprGetRealPowerExponent(expr),
+                                      &powchildren[1]));
+            CSIP_CALL(appendTapeOp(tape, POW, 2, powchildren, opidx));
+        }
+        break;
+    case SCIP_EXPR_INTPOWER:
+        {
+            int powchildren[2];
+            CSIP_CALL(exprToTape(exprchildren[0], treevars, varindex, tape,
+                                 &powchildren[0]));
+            CSIP_CALL(appendTapeConst(tape, SCIPexprGetIntPowerExponent(expr),
+                                      &powchildren[1]));
+            CSIP_CALL(appendTapeOp(tape, OPINTPOWER, 2, powchildren, opidx));
+        }
+        break;
+    case SCIP_EXPR_MINUS:
+    case SCIP_EXPR_DIV:
+    case SCIP_EXPR_SQUARE:
+    case SCIP_EXPR_SQRT:
+    case SCIP_EXPR_EXP:
+    case SCIP_EXPR_LOG:
+    case SCIP_EXPR_SIN:
+    case SCIP_EXPR_COS:
+    case SCIP_EXPR_MIN:
+    case SCIP_EXPR_MAX:
+    case SCIP_EXPR_ABS:
+    case SCIP_EXPR_SUM:
+    case SCIP_EXPR_PRODUCT:
+    case SCIP_EXPR_LINEAR:
+    case SCIP_EXPR_QUADRATIC:
+    case SCIP_EXPR_POLYNOMIAL:
+        childops = (int *) malloc(nchildren * sizeof(int));
+        if (nchildren > 0 && childops == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+        for (c = 0; c < nchildren; ++c)
+        {
+            CSIP_CALL(exprToTape(exprchildren[c], treevars, varindex, tape,
+                                 &childops[c]));
+        }
+        if (SCIPexprGetOperator(expr) == SCIP_EXPR_LINEAR
+                || SCIPexprGetOperator(expr) == SCIP_EXPR_QUADRATIC
+                || SCIPexprGetOperator(expr) == SCIP_EXPR_POLYNOMIAL)
+        {
+            CSIP_CALL(appendTapeNary(expr, childops, tape, opidx));
+        }
+        else
+        {
+            CSIP_CALL(appendTapeOp(tape, SCIPexprGetOperator(expr), nchildren,
+                                   childops, opidx));
+        }
+        free(childops);
+        break;
+    default: // not created by CSIP
+        return CSIP_RETCODE_ERROR;
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+// map the problem index of each variable to its CSIP index (or -1)
+static
+CSIP_RETCODE createVarIndexMap(CSIP_MODEL *model, int **varindex)
+{
+    int norigvars = SCIPgetNOrigVars(model->scip);
+
+    *varindex = (int *) malloc(norigvars * sizeof(int));
+    if (norigvars > 0 && *varindex == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    for (int i = 0; i < norigvars; ++i)
+    {
+        (*varindex)[i] = -1;
+    }
+    for (int i = 0; i < model->nvars; ++i)
+    {
+        (*varindex)[SCIPvarGetProbindex(model->vars[i])] = i;
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+/** When the objective is nonlinear we use the epigraph representation.
+ * However, changing the objective sense is not  straightforward in that
+ * case. The purpose of this function is to change an epigraph objective
+ * to represent the correct objective sense. *Starting* from a correct
+ * objective, we only need two modifications to correctly change the sense.
+ * 0) change sense (this step is not done here)
+ * 1) multiply objective function by -1
+ * 2) multiply nonlinear function by -1
+ * max{ t : f(x) >= t } --> min{ -t : -f(x) >= t }
+ * min{ t : f(x) <= t } --> max{ -t : -f(x) <= t }
+ */
+CSIP_RETCODE correctObjectiveFunction(CSIP_MODEL *model)
+{
+    SCIP *scip = model->scip;
+    SCIP_CONS *objcons = model->objcons;
+    SCIP_VAR *objvar = model->objvar;
+
+    // we only apply this for nonlinear objectives
+    if (objvar == NULL)
+    {
+        return CSIP_RETCODE_OK;
+    }
+
+    assert(objcons != NULL);
+    model->hasobjpoint = FALSE;
+
+    // 1)
+    SCIP_in_CSIP(SCIPchgVarObj(scip, objvar, -1.0 * SCIPvarGetObj(objvar)));
+
+    // 2)
+    // we need to copy the tree, because SCIPsetExprtreesNonlinear
+    // is going to delete it
+    SCIP_EXPRTREE *exprtree;
+    SCIP_in_CSIP(SCIPexprtreeCopy(SCIPblkmem(scip), &exprtree,
+                                  SCIPgetExprtreesNonlinear(scip, objcons)[0]));
+    SCIP_Real exprtreecoef = -SCIPgetExprtreeCoefsNonlinear(scip, objcons)[0];
+
+    SCIP_in_CSIP(SCIPsetExprtreesNonlinear(scip, objcons, 1, &exprtree,
+                                           &exprtreecoef));
+
+    return CSIP_RETCODE_OK;
+}
+
+/*
+ * interface methods
+ */
+int CSIPmajorVersion()
+{
+    return CSIP_MAJOR_VERSION;
+}
+
+int CSIPminorVersion()
+{
+    return CSIP_MINOR_VERSION;
+}
+
+int CSIPpatchVersion()
+{
+    return CSIP_PATCH_VERSION;
+}
+
+int CSIPgetVersion()
+{
+    return (100 * CSIPmajorVersion()
+            + 10 * CSIPminorVersion()
+            + 1 * CSIPpatchVersion());
+}
+
+// initialize an empty model around a SCIP that has a problem
+static
+CSIP_RETCODE initModel(CSIP_MODEL *model)
+{
+    model->nvars = 0;
+    model->varssize = INITIALSIZE;
+    model->vars = (SCIP_VAR **) malloc(INITIALSIZE * sizeof(SCIP_VAR *));
+    if (model->vars == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    model->ndelvars = 0;
+    model->ndelconss = 0;
+
+    model->tempfixings = FALSE;
+
+    model->ngroups = 0;
+    model->groupssize = 0;
+    model->groups = NULL;
+
+    model->nconss = 0;
+    model->consssize = INITIALSIZE;
+    model->conss = (SCIP_CONS **) malloc(INITIALSIZE * sizeof(SCIP_CONS *));
+    model->consactive = (SCIP_Bool *) malloc(INITIALSIZE * sizeof(SCIP_Bool));
+    if (model->conss == NULL || model->consactive == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    model->nlazycb = 0;
+    model->nheur = 0;
+    model->neventhdlr = 0;
+    model->ninitialsols = 0;
+    model->initialsolssize = 0;
+    model->initialsols = NULL;
+    model->objvar = NULL;
+    model->objcons = NULL;
+    model->objtype = CSIP_OBJTYPE_LINEAR;
+    model->objpoint = NULL;
+    model->hasobjpoint = FALSE;
+    model->msghdlr = NULL;
+
+    model->nlazycalls = 0;
+    model->nheurcalls = 0;
+    SCIP_in_CSIP(SCIPcreateClock(model->scip, &model->lazyclock));
+    SCIP_in_CSIP(SCIPcreateClock(model->scip, &model->heurclock));
+
+    model->timing = FALSE;
+    for (int i = 0; i < CSIP_NPHASES; ++i)
+    {
+        model->phasecalls[i] = 0;
+        model->phasetime[i] = 0.0;
+    }
+
+    model->sepanames = NULL;
+    model->sepancuts = NULL;
+    model->heurnames = NULL;
+    model->heurtimes = NULL;
+
+    model->varnames.names = NULL;
+    model->varnames.namelens = NULL;
+    model->varnames.values = NULL;
+    model->consnames.names = NULL;
+    model->consnames.namelens = NULL;
+    model->consnames.values = NULL;
+
+    model->cache = NULL;
+    model->hasfingerprint = FALSE;
+    model->fingerprint = 0;
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPcreateModel(CSIP_MODEL **modelptr)
+{
+    CSIP_MODEL *model;
+
+    *modelptr = (CSIP_MODEL *)malloc(sizeof(CSIP_MODEL));
+    if (*modelptr == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    model = *modelptr;
+
+    SCIP_in_CSIP(SCIPcreate(&model->scip));
+    SCIP_in_CSIP(SCIPincludeDefaultPlugins(model->scip));
+    SCIP_in_CSIP(SCIPcreateProbBasic(model->scip, "name"));
+
+    CSIP_CALL(initModel(model));
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPfreeModel(CSIP_MODEL *model)
+{
+    int i;
+
+    // solve was not called?
+    CSIP_CALL(freeInitialSolutions(model));
+
+    /* SCIPreleaseVar sets the given pointer to NULL. However, this pointer is
+     * needed when SCIPfree is called, because it will call the lock method again
+     * which works on the vars stored at model, so we give another pointer
+     * TODO: maybe this is still wrong and one should free the transformed problem
+     * first and then release the vars... we have to check for BMS memory leaks
+     */
+    for (i = 0; i < model->nvars; ++i)
+    {
+        SCIP_VAR *var;
+        var = model->vars[i];
+        SCIP_in_CSIP(SCIPreleaseVar(model->scip, &var));
+    }
+    for (i = 0; i < model->nconss; ++i)
+    {
+        SCIP_in_CSIP(SCIPreleaseCons(model->scip, &model->conss[i]));
+    }
+    if (model->objvar != NULL)
+    {
+        assert(model->objcons != NULL);
+        SCIP_in_CSIP(SCIPreleaseVar(model->scip, &model->objvar));
+        SCIP_in_CSIP(SCIPreleaseCons(model->scip, &model->objcons));
+    }
+    SCIP_in_CSIP(SCIPfreeClock(model->scip, &model->lazyclock));
+    SCIP_in_CSIP(SCIPfreeClock(model->scip, &model->heurclock));
+    SCIP_in_CSIP(SCIPfree(&model->scip));
+
+    free(model->sepanames);
+    free(model->sepancuts);
+    free(model->heurnames);
+    free(model->heurtimes);
+    freeNameTable(&model->varnames);
+    freeNameTable(&model->consnames);
+    free(model->initialsols);
+    free(model->objpoint);
+    for (i = 0; i < model->ngroups; ++i)
+    {
+        free(model->groups[i].name);
+        free(model->groups[i].conss);
+    }
+    free(model->groups);
+    free(model->conss);
+    free(model->consactive);
+    free(model->vars);
+    free(model);
+
+    return CSIP_RETCODE_OK;
+}
+
+// add a variable; without a name, it is named by its index
+static
+CSIP_RETCODE addVar(CSIP_MODEL *model, double lowerbound, double upperbound,
+                    int vartype, const char *name, int *idx)
+{
+    SCIP *scip;
+    SCIP_VAR *var;
+    char defaultname[SCIP_MAXSTRLEN];
+
+    scip = model->scip;
+
+    if (name == NULL)
+    {
+        (void) SCIPsnprintf(defaultname, SCIP_MAXSTRLEN, "x%d",
+                            model->nvars + model->ndelvars);
+        name = defaultname;
+    }
+    SCIP_in_CSIP(SCIPcreateVarBasic(scip, &var, name, lowerbound, upperbound, 0.0,
+                                    vartype));
+    SCIP_in_CSIP(SCIPaddVar(scip, var));
+
+    // do we need to resize?
+    if (model->nvars >= model->varssize)
+    {
+        model->varssize = GROWFACTOR * model->varssize;
+        model->vars = (SCIP_VAR **) realloc(
+                          model->vars,  model->varssize * sizeof(SCIP_VAR *));
+        if (model->vars == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+    }
+
+    if (idx != NULL)
+    {
+        *idx = model->nvars;
+        model->vars[*idx] = var;
+    }
+    else
+    {
+        model->vars[model->nvars] = var;
+    }
+
+    if (model->varnames.names != NULL)
+    {
+        name = SCIPvarGetName(var);
+        CSIP_CALL(insertName(&model->varnames, name, strlen(name),
+                             model->nvars));
+    }
+    ++(model->nvars);
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddVar(CSIP_MODEL *model, double lowerbound, double upperbound,
+                        int vartype, int *idx)
+{
+    CSIP_CALL(freeTransform(model));
+
+    CSIP_CALL(addVar(model, lowerbound, upperbound, vartype, NULL, idx));
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddVars(CSIP_MODEL *model, int numvars, double *lowerbounds,
+                         double *upperbounds, int *vartypes, const char **names)
+{
+    CSIP_CALL(freeTransform(model));
+
+    for (int i = 0; i < numvars; ++i)
+    {
+        CSIP_CALL(addVar(model, lowerbounds[i], upperbounds[i], vartypes[i],
+                         names == NULL ? NULL : names[i], NULL));
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPchgVarLB(CSIP_MODEL *model, int numindices, int *indices,
+                          double *lowerbounds)
+{
+    int i;
+    SCIP *scip;
+    SCIP_VAR *var;
+
+    scip = model->scip;
+    CSIP_CALL(freeTransform(model));
+
+    for (i = 0; i < numindices; ++i)
+    {
+        var = model->vars[indices[i]];
+        SCIP_in_CSIP(SCIPchgVarLb(scip, var, lowerbounds[i]));
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPchgVarUB(CSIP_MODEL *model, int numindices, int *indices,
+                          double *upperbounds)
+{
+    int i;
+    SCIP *scip;
+    SCIP_VAR *var;
+
+    scip = model->scip;
+    CSIP_CALL(freeTransform(model));
+
+    for (i = 0; i < numindices; ++i)
+    {
+        var = model->vars[indices[i]];
+        SCIP_in_CSIP(SCIPchgVarUb(scip, var, upperbounds[i]));
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPchgVarType(
+    CSIP_MODEL *model, int varindex, CSIP_VARTYPE vartype)
+{
+    SCIP *scip = model->scip;
+    SCIP_VAR *var = model->vars[varindex];
+    SCIP_Bool infeas = FALSE;
+
+    CSIP_CALL(freeTransform(model));
+
+    SCIP_in_CSIP(SCIPchgVarType(scip, var, vartype, &infeas));
+    // TODO: don't ignore `infeas`?
+    // for SCIP, solving a problem with a binary variable with bounds not in [0,1] produces an error
+    // here we change them to the correct value, since JuMP seems to expect that behaviour
+    // see JuMP tests: [probmod] Test bound modification on binaries
+    if (vartype == CSIP_VARTYPE_BINARY && SCIPvarGetLbLocal(var) < 0.0)
+    {
+        SCIP_in_CSIP(SCIPchgVarLb(scip, var, 0.0));
+    }
+    if (vartype == CSIP_VARTYPE_BINARY && SCIPvarGetUbLocal(var) > 1.0)
+    {
+        SCIP_in_CSIP(SCIPchgVarUb(scip, var, 1.0));
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_VARTYPE CSIPgetVarType(CSIP_MODEL *model, int varindex)
+{
+    assert(varindex >= 0 && varindex < model->nvars);
+
+    switch (SCIPvarGetType(model->vars[varindex]))
+    {
+    case SCIP_VARTYPE_BINARY:
+        return CSIP_VARTYPE_BINARY;
+    case SCIP_VARTYPE_INTEGER:
+        return CSIP_VARTYPE_INTEGER;
+    case SCIP_VARTYPE_IMPLINT:
+        return CSIP_VARTYPE_IMPLINT;
+    case SCIP_VARTYPE_CONTINUOUS:
+        return CSIP_VARTYPE_CONTINUOUS;
+    }
+    return -1;
+}
+
+CSIP_RETCODE CSIPaddLinCons(CSIP_MODEL *model, int numindices, int *indices,
+                            double *coefs, double lhs, double rhs, int *idx)
+{
+    SCIP_CONS *cons;
+    char name[SCIP_MAXSTRLEN];
+
+    CSIP_CALL(freeTransform(model));
+
+    consName(model, name);
+    CSIP_CALL(createLinCons(model, name, numindices, indices, coefs, lhs, rhs,
+                            &cons));
+    CSIP_CALL(addCons(model, cons, idx));
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddQuadCons(CSIP_MODEL *model, int numlinindices,
+                             int *linindices,
+                             double *lincoefs, int numquadterms,
+                             int *quadrowindices, int *quadcolindices,
+                             double *quadcoefs, double lhs, double rhs, int *idx)
+{
+    int i;
+    SCIP *scip;
+    SCIP_VAR *linvar;
+    SCIP_VAR *var1;
+    SCIP_VAR *var2;
+    SCIP_CONS *cons;
+    char name[SCIP_MAXSTRLEN];
+
+    scip = model->scip;
+    CSIP_CALL(freeTransform(model));
+
+    consName(model, name);
+    SCIP_in_CSIP(SCIPcreateConsBasicQuadratic(scip, &cons, name, 0, NULL,
+                 NULL, 0, NULL, NULL, NULL, lhs, rhs));
+
+    for (i = 0; i < numlinindices; ++i)
+    {
+        linvar = model->vars[linindices[i]];
+        SCIP_in_CSIP(SCIPaddLinearVarQuadratic(scip, cons, linvar, lincoefs[i]));
+    }
+
+    for (i = 0; i < numquadterms; ++i)
+    {
+        var1 = model->vars[quadrowindices[i]];
+        var2 = model->vars[quadcolindices[i]];
+        SCIP_in_CSIP(SCIPaddBilinTermQuadratic(scip, cons, var1, var2, quadcoefs[i]));
+    }
+
+    CSIP_CALL(addCons(model, cons, idx));
+
+    return CSIP_RETCODE_OK;
+}
+
+// we might be assuming that the indices of the children of op[k]
+// are always <= k (when op[k] is not VARIDX nor CONST)
+// this implies that the root expression is the last one, which is
+// another assumption
+CSIP_RETCODE CSIPaddNonLinCons(
+    CSIP_MODEL *model, int nops, CSIP_OP *ops, int *children, int *begin,
+    double *values, double lhs, double rhs, int *idx)
+{
+    SCIP *scip;
+    SCIP_EXPRTREE *tree;
+    SCIP_CONS *cons;
+    CSIP_RETCODE retcode;
+    char name[SCIP_MAXSTRLEN];
+
+    retcode = createExprtree(model, nops, ops, children, begin, values, &tree);
+    if (retcode != CSIP_RETCODE_OK)
+    {
+        return retcode;
+    }
+
+    scip = model->scip;
+    CSIP_CALL(freeTransform(model));
+
+    // create nonlinear constraint
+    consName(model, name);
+    SCIP_in_CSIP(SCIPcreateConsBasicNonlinear(scip, &cons, name, 0, NULL, NULL,
+                 1, &tree, NULL, lhs, rhs));
+
+    CSIP_CALL(addCons(model, cons, idx));
+
+    // free memory
+    SCIP_in_CSIP(SCIPexprtreeFree(&tree));
+
+    return CSIP_RETCODE_OK;
+}
+
+/* add SOS1 or SOS2 constraints given in sparse row format; the first index is
+ * assigned to idx, if not NULL */
+static
+CSIP_RETCODE addSOSs(CSIP_MODEL *model, SCIP_Bool sos1, int nsets, int *begin,
+                     int *indices, double *weights, int *idx)
+{
+    SCIP *scip = model->scip;
+    SCIP_VAR **vars;
+    double *auxweights;
+    int maxlen = 1;
+
+    for (int k = 0; k < nsets; ++k)
+    {
+        maxlen = MAX(maxlen, begin[k + 1] - begin[k]);
+    }
+
+    // buffers are shared by all sets
+    vars = (SCIP_VAR **) malloc(maxlen * sizeof(SCIP_VAR *));
+    auxweights = (double *) malloc(maxlen * sizeof(double));
+    if (vars == NULL || auxweights == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    /* give weights to avoid an assert in SCIP */
+    for (int i = 0; i < maxlen; ++i)
+    {
+        auxweights[i] = i;
+    }
+
+    for (int k = 0; k < nsets; ++k)
+    {
+        SCIP_CONS *cons;
+        int n = begin[k + 1] - begin[k];
+        double *setweights = weights == NULL ? auxweights : &weights[begin[k]];
+        char name[SCIP_MAXSTRLEN];
+
+        for (int i = 0; i < n; ++i)
+        {
+            vars[i] = model->vars[indices[begin[k] + i]];
+        }
+
+        consName(model, name);
+        if (sos1)
+        {
+            SCIP_in_CSIP(SCIPcreateConsBasicSOS1(scip, &cons, name, n, vars,
+                                                 setweights));
+        }
+        else
+        {
+            SCIP_in_CSIP(SCIPcreateConsBasicSOS2(scip, &cons, name, n, vars,
+                                                 setweights));
+        }
+        CSIP_CALL(addCons(model, cons, k == 0 ? idx : NULL));
+    }
+
+    free(auxweights);
+    free(vars);
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddSOS1(
+    CSIP_MODEL *model, int numindices, int *indices, double *weights, int *idx)
+{
+    int begin[] = {0, numindices};
+
+    CSIP_CALL(freeTransform(model));
+    CSIP_CALL(addSOSs(model, TRUE, 1, begin, indices, weights, idx));
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddSOS2(
+    CSIP_MODEL *model, int numindices, int *indices, double *weights, int *idx)
+{
+    int begin[] = {0, numindices};
+
+    CSIP_CALL(freeTransform(model));
+    CSIP_CALL(addSOSs(model, FALSE, 1, begin, indices, weights, idx));
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddSOS1Batch(
+    CSIP_MODEL *model, int nsets, int *begin, int *indices, double *weights)
+{
+    CSIP_CALL(freeTransform(model));
+    CSIP_CALL(addSOSs(model, TRUE, nsets, begin, indices, weights, NULL));
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddSOS2Batch(
+    CSIP_MODEL *model, int nsets, int *begin, int *indices, double *weights)
+{
+    CSIP_CALL(freeTransform(model));
+    CSIP_CALL(addSOSs(model, FALSE, nsets, begin, indices, weights, NULL));
+
+    return CSIP_RETCODE_OK;
+}
+
+/* lambda formulation: x = sum_i xs[i] l_i, y = sum_i ys[i] l_i, sum_i l_i = 1,
+ * l >= 0 and SOS2(l) */
+CSIP_RETCODE CSIPaddPiecewiseLinear(
+    CSIP_MODEL *model, int xidx, int yidx, int npoints, double *xs, double *ys)
+{
+    SCIP_CONS *cons;
+    int *indices;
+    double *coefs;
+    int firstlambda = model->nvars;
+    int begin[] = {0, npoints};
+    char name[SCIP_MAXSTRLEN];
+
+    if (npoints < 1 || xidx < 0 || xidx >= model->nvars || yidx < 0
+            || yidx >= model->nvars)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    CSIP_CALL(freeTransform(model));
+
+    indices = (int *) malloc((npoints + 1) * sizeof(int));
+    coefs = (double *) malloc((npoints + 1) * sizeof(double));
+    if (indices == NULL || coefs == NULL)
+    {
+        free(indices);
+        free(coefs);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    for (int i = 0; i < npoints; ++i)
+    {
+        CSIP_CALL(addVar(model, 0.0, 1.0, CSIP_VARTYPE_CONTINUOUS, NULL, NULL));
+        indices[i + 1] = firstlambda + i;
+    }
+
+    // x and y as combinations of the points
+    indices[0] = xidx;
+    coefs[0] = 1.0;
+    for (int i = 0; i < npoints; ++i)
+    {
+        coefs[i + 1] = -xs[i];
+    }
+    consName(model, name);
+    CSIP_CALL(createLinCons(model, name, npoints + 1, indices, coefs, 0.0, 0.0,
+                            &cons));
+    CSIP_CALL(addCons(model, cons, NULL));
+
+    indices[0] = yidx;
+    for (int i = 0; i < npoints; ++i)
+    {
+        coefs[i + 1] = -ys[i];
+    }
+    consName(model, name);
+    CSIP_CALL(createLinCons(model, name, npoints + 1, indices, coefs, 0.0, 0.0,
+                            &cons));
+    CSIP_CALL(addCons(model, cons, NULL));
+
+    // convexity
+    for (int i = 0; i < npoints; ++i)
+    {
+        coefs[i + 1] = 1.0;
+    }
+    consName(model, name);
+    CSIP_CALL(createLinCons(model, name, npoints, &indices[1], &coefs[1], 1.0,
+                            1.0, &cons));
+    CSIP_CALL(addCons(model, cons, NULL));
+
+    CSIP_CALL(addSOSs(model, FALSE, 1, begin, &indices[1], NULL, NULL));
+
+    free(indices);
+    free(coefs);
+
+    return CSIP_RETCODE_OK;
+}
+
+/* the linear row of an indicator constraint, or NULL for other constraints;
+ * SCIP adds the row to the problem as a constraint of its own, with a slack
+ * variable
+ */
+static
+SCIP_CONS *getIndicatorRow(SCIP_CONS *cons)
+{
+    if (strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(cons)), "indicator") != 0)
+    {
+        return NULL;
+    }
+
+    return SCIPgetLinearConsIndicator(cons);
+}
+
+// add the indicator constraint binvar = 1 -> sum_i coefs[i] * vars[i] <= rhs
+static
+CSIP_RETCODE addIndicatorRow(CSIP_MODEL *model, SCIP_VAR *binvar,
+                             int numindices, int *indices, double *coefs,
+                             double rhs, int *idx)
+{
+    SCIP_CONS *cons;
+    SCIP_VAR **vars;
+    char name[SCIP_MAXSTRLEN];
+
+    vars = (SCIP_VAR **) malloc(MAX(numindices, 1) * sizeof(SCIP_VAR *));
+    if (vars == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    for (int i = 0; i < numindices; ++i)
+    {
+        vars[i] = model->vars[indices[i]];
+    }
+
+    consName(model, name);
+    SCIP_in_CSIP(SCIPcreateConsBasicIndicator(model->scip, &cons, name, binvar,
+                 numindices, vars, coefs, rhs));
+    CSIP_CALL(addCons(model, cons, idx));
+    free(vars);
+
+    return CSIP_RETCODE_OK;
+}
+
+// whether an indicator row can be added, checked before anything is added
+static
+SCIP_Bool isValidIndicator(CSIP_MODEL *model, int binindex, int activeval,
+                           int numindices, const int *indices, double lhs,
+                           double rhs)
+{
+    if (binindex < 0 || binindex >= model->nvars
+            || SCIPvarGetType(model->vars[binindex]) != SCIP_VARTYPE_BINARY
+            || (activeval != 0 && activeval != 1) || numindices < 0
+            || (SCIPisInfinity(model->scip, -lhs)
+                && SCIPisInfinity(model->scip, rhs)))
+    {
+        return FALSE;
+    }
+    for (int i = 0; i < numindices; ++i)
+    {
+        if (indices[i] < 0 || indices[i] >= model->nvars)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+CSIP_RETCODE CSIPaddIndicator(
+    CSIP_MODEL *model, int binindex, int activeval, int numindices,
+    int *indices, double *coefs, double lhs, double rhs, int *idx)
+{
+    SCIP *scip = model->scip;
+    SCIP_VAR *binvar;
+    SCIP_Bool haslhs = !SCIPisInfinity(scip, -lhs);
+    SCIP_Bool hasrhs = !SCIPisInfinity(scip, rhs);
+
+    if (!isValidIndicator(model, binindex, activeval, numindices, indices, lhs,
+                          rhs))
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    CSIP_CALL(freeTransform(model));
+
+    // cons_indicator activates on 1, so use the negated variable for 0
+    binvar = model->vars[binindex];
+    if (!activeval)
+    {
+        SCIP_in_CSIP(SCIPgetNegatedVar(scip, binvar, &binvar));
+    }
+
+    if (hasrhs)
+    {
+        CSIP_CALL(addIndicatorRow(model, binvar, numindices, indices, coefs,
+                                  rhs, idx));
+    }
+    if (haslhs)
+    {
+        double *negcoefs = (double *) malloc(MAX(numindices, 1)
+                                             * sizeof(double));
+        if (negcoefs == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+        for (int i = 0; i < numindices; ++i)
+        {
+            negcoefs[i] = -coefs[i];
+        }
+        CSIP_CALL(addIndicatorRow(model, binvar, numindices, indices, negcoefs,
+                                  -lhs, hasrhs ? NULL : idx));
+        free(negcoefs);
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddIndicators(
+    CSIP_MODEL *model, int ncons, int *binindices, int *activevals, int *begin,
+    int *indices, double *coefs, double *lhss, double *rhss, int *idx)
+{
+    CSIP_RETCODE retcode = CSIP_RETCODE_OK;
+
+    // all rows are checked first, so that an invalid row adds nothing
+    for (int k = 0; k < ncons; ++k)
+    {
+        if (begin[k + 1] < begin[k]
+                || !isValidIndicator(model, binindices[k], activevals[k],
+                                     begin[k + 1] - begin[k],
+                                     &indices[begin[k]], lhss[k], rhss[k]))
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+    }
+
+    for (int k = 0; retcode == CSIP_RETCODE_OK && k < ncons; ++k)
+    {
+        retcode = CSIPaddIndicator(model, binindices[k], activevals[k],
+                                   begin[k + 1] - begin[k], &indices[begin[k]],
+                                   &coefs[begin[k]], lhss[k], rhss[k],
+                                   idx == NULL ? NULL : &idx[k]);
+    }
+
+    return retcode;
+}
+
+/* whether a variable can be semicontinuous with the given lower bound: with
+ * another lower bound than 0, the disjunction would not allow 0, and the
+ * semicontinuous lower bound must lie in (0, ub]
+ */
+static
+SCIP_Bool isValidSemicontinuous(CSIP_MODEL *model, int idx, double lowerbound)
+{
+    return idx >= 0 && idx < model->nvars
+           && SCIPvarGetLbOriginal(model->vars[idx]) == 0.0
+           && lowerbound > 0.0
+           && lowerbound <= SCIPvarGetUbOriginal(model->vars[idx]);
+}
+
+/* x is 0 or at least its semicontinuous lower bound l, i.e., the bound
+ * disjunction x <= 0 or x >= l */
+CSIP_RETCODE CSIPaddSemicontinuous(
+    CSIP_MODEL *model, int numindices, int *indices, double *lowerbounds)
+{
+    SCIP *scip = model->scip;
+    SCIP_BOUNDTYPE boundtypes[2] = {SCIP_BOUNDTYPE_UPPER, SCIP_BOUNDTYPE_LOWER};
+
+    for (int i = 0; i < numindices; ++i)
+    {
+        if (!isValidSemicontinuous(model, indices[i], lowerbounds[i]))
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+    }
+
+    CSIP_CALL(freeTransform(model));
+
+    for (int i = 0; i < numindices; ++i)
+    {
+        SCIP_CONS *cons;
+        SCIP_VAR *vars[2];
+        double bounds[2] = {0.0, lowerbounds[i]};
+        char name[SCIP_MAXSTRLEN];
+
+        vars[0] = model->vars[indices[i]];
+        vars[1] = vars[0];
+
+        consName(model, name);
+        SCIP_in_CSIP(SCIPcreateConsBasicBounddisjunction(scip, &cons, name, 2,
+                     vars, boundtypes, bounds));
+        CSIP_CALL(addCons(model, cons, NULL));
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetObj(CSIP_MODEL *model, int numindices, int *indices,
+                        double *coefs)
+{
+    int i;
+    SCIP *scip;
+    SCIP_VAR *var;
+
+    scip = model->scip;
+    CSIP_CALL(freeTransform(model));
+
+    for (i = 0; i < numindices; ++i)
+    {
+        var = model->vars[indices[i]];
+        SCIP_in_CSIP(SCIPchgVarObj(scip, var, coefs[i]));
+    }
+    model->objtype = CSIP_OBJTYPE_LINEAR;
+
+    CSIP_CALL(removeNonlinearObj(model));
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPchgObjCoefs(CSIP_MODEL *model, int numindices, int *indices,
+                             double *coefs)
+{
+    SCIP *scip;
+    int first;
+
+    scip = model->scip;
+
+    // skip coefficients that do not change, so that we keep the transformed
+    // problem if nothing changes at all
+    for (first = 0; first < numindices; ++first)
+    {
+        if (SCIPvarGetObj(model->vars[indices[first]]) != coefs[first])
+        {
+            break;
+        }
+    }
+    if (first == numindices)
+    {
+        return CSIP_RETCODE_OK;
+    }
+
+    CSIP_CALL(freeTransform(model));
+
+    for (int i = first; i < numindices; ++i)
+    {
+        SCIP_VAR *var = model->vars[indices[i]];
+
+        if (SCIPvarGetObj(var) != coefs[i])
+        {
+            SCIP_in_CSIP(SCIPchgVarObj(scip, var, coefs[i]));
+        }
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPclearObj(CSIP_MODEL *model)
+{
+    SCIP *scip;
+
+    scip = model->scip;
+    CSIP_CALL(freeTransform(model));
+
+    for (int i = 0; i < model->nvars; ++i)
+    {
+        if (SCIPvarGetObj(model->vars[i]) != 0.0)
+        {
+            SCIP_in_CSIP(SCIPchgVarObj(scip, model->vars[i], 0.0));
+        }
+    }
+    model->objtype = CSIP_OBJTYPE_LINEAR;
+
+    CSIP_CALL(removeNonlinearObj(model));
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetQuadObj(CSIP_MODEL *model, int numlinindices,
+                            int *linindices, double *lincoefs, int numquadterms,
+                            int *quadrowindices, int *quadcolindices,
+                            double *quadcoefs)
+{
+    int nexprs = 0;
+    int nops;
+    int nchildren;
+    int nvalues;
+    int pos;
+    CSIP_OP *ops;
+    int *children;
+    int *begin;
+    int *exprpos;
+    int *exprvars;
+    double *values;
+    CSIP_RETCODE retcode;
+
+    // build a single QUADRATIC operator over one VARIDX per variable; see
+    // CSIPaddNonLinCons for the format. exprpos maps a variable to its child.
+    exprpos = (int *) malloc(MAX(model->nvars, 1) * sizeof(int));
+    exprvars = (int *) malloc(MAX(numlinindices + 2 * numquadterms, 1)
+                              * sizeof(int));
+    if (exprpos == NULL || exprvars == NULL)
+    {
+        free(exprvars);
+        free(exprpos);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    for (int i = 0; i < model->nvars; ++i)
+    {
+        exprpos[i] = -1;
+    }
+    for (int i = 0; i < numlinindices + 2 * numquadterms; ++i)
+    {
+        int varidx = i < numlinindices ? linindices[i]
+                     : ((i - numlinindices) % 2 == 0
+                        ? quadrowindices[(i - numlinindices) / 2]
+                        : quadcolindices[(i - numlinindices) / 2]);
+        if (varidx < 0 || varidx >= model->nvars)
+        {
+            free(exprvars);
+            free(exprpos);
+            return CSIP_RETCODE_ERROR;
+        }
+        if (exprpos[varidx] == -1)
+        {
+            exprpos[varidx] = nexprs;
+            exprvars[nexprs] = varidx;
+            ++nexprs;
+        }
+    }
+
+    // the values are the constant, the linear coefs and the quadratic coefs
+    nops = nexprs + 1;
+    nchildren = nexprs + 2 * nexprs + 2 + 3 * numquadterms;
+    nvalues = 1 + nexprs + numquadterms;
+
+    ops = (int *) malloc(nops * sizeof(CSIP_OP));
+    children = (int *) malloc(nchildren * sizeof(int));
+    begin = (int *) malloc((nops + 1) * sizeof(int));
+    values = (double *) malloc(nvalues * sizeof(double));
+    if (ops == NULL || children == NULL || begin == NULL || values == NULL)
+    {
+        free(ops);
+        free(children);
+        free(begin);
+        free(values);
+        free(exprvars);
+        free(exprpos);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    for (int c = 0; c < nexprs; ++c)
+    {
+        ops[c] = VARIDX;
+        begin[c] = c;
+        children[c] = exprvars[c];
+    }
+
+    ops[nexprs] = QUADRATIC;
+    begin[nexprs] = nexprs;
+    begin[nexprs + 1] = nchildren;
+    pos = nexprs;
+    children[pos++] = nexprs;
+    for (int c = 0; c < nexprs; ++c)
+    {
+        children[pos++] = c;
+    }
+
+    values[0] = 0.0;
+    children[pos++] = 0;
+    for (int c = 0; c < nexprs; ++c)
+    {
+        values[1 + c] = 0.0;
+        children[pos++] = 1 + c;
+    }
+    for (int i = 0; i < numlinindices; ++i)
+    {
+        values[1 + exprpos[linindices[i]]] += lincoefs[i];
+    }
+
+    for (int i = 0; i < numquadterms; ++i)
+    {
+        children[pos++] = exprpos[quadrowindices[i]];
+        children[pos++] = exprpos[quadcolindices[i]];
+        values[1 + nexprs + i] = quadcoefs[i];
+        children[pos++] = 1 + nexprs + i;
+    }
+    assert(pos == nchildren);
+
+    retcode = CSIPsetNonlinearObj(model, nops, ops, children, begin, values);
+
+    // free everything
+    free(ops);
+    free(children);
+    free(begin);
+    free(values);
+    free(exprvars);
+    free(exprpos);
+
+    return retcode;
+}
+
+CSIP_RETCODE CSIPsetNonlinearObj(
+    CSIP_MODEL *model, int nops, CSIP_OP *ops, int *children, int *begin,
+    double *values)
+{
+    SCIP *scip;
+    SCIP_EXPRTREE *tree = NULL;
+    SCIP_CONS *cons;
+
+    if (nops < 1)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    // build the tree first, so that invalid input leaves the old objective;
+    // a single constant is an empty expression tree
+    if (nops > 1 || ops[0] == SCIP_EXPR_VARIDX)
+    {
+        CSIP_RETCODE retcode = createExprtree(model, nops, ops, children, begin,
+                                              values, &tree);
+        if (retcode != CSIP_RETCODE_OK)
+        {
+            return retcode;
+        }
+    }
+
+    // get scip, free transform and remove old objective if any
+    scip = model->scip;
+    CSIP_CALL(freeTransform(model));
+
+    CSIP_CALL(removeNonlinearObj(model));
+
+    // do nothing more if we received an empty expression tree
+    if (tree == NULL)
+    {
+       return CSIP_RETCODE_OK;
+    }
+
+    // create nonlinear objective constraint
+    SCIP_in_CSIP(SCIPcreateConsBasicNonlinear(scip, &cons,
+                 "nonlin_obj", 0, NULL, NULL, 1, &tree, NULL,
+                 -SCIPinfinity(scip), 0.0));
+
+    // add objvar to nonlinear objective
+    SCIP_in_CSIP(SCIPcreateVarBasic(scip, &model->objvar, "objvar",
+                                    -SCIPinfinity(scip), SCIPinfinity(scip), 1.0,
+                                    SCIP_VARTYPE_CONTINUOUS));
+    SCIP_in_CSIP(SCIPaddVar(scip, model->objvar));
+    SCIP_in_CSIP(SCIPaddLinearVarNonlinear(scip, cons, model->objvar, -1.0));
+
+    // add objective constraint and remember it
+    SCIP_in_CSIP(SCIPaddCons(scip, cons));
+    model->objcons = cons;
+    model->objtype = CSIP_OBJTYPE_NONLINEAR;
+
+    // the created constraint is correct if sense is minimize, otherwise we
+    // have to correct it
+    if (SCIPgetObjsense(model->scip) == SCIP_OBJSENSE_MAXIMIZE)
+    {
+        CSIP_CALL(correctObjectiveFunction(model));
+    }
+
+    // free memory
+    SCIP_in_CSIP(SCIPexprtreeFree(&tree));
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetSenseMinimize(CSIP_MODEL *model)
+{
+    CSIP_CALL(freeTransform(model));
+
+    if (SCIPgetObjsense(model->scip) != SCIP_OBJSENSE_MINIMIZE)
+    {
+        SCIP_in_CSIP(SCIPsetObjsense(model->scip, SCIP_OBJSENSE_MINIMIZE));
+        CSIP_CALL(correctObjectiveFunction(model));
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetSenseMaximize(CSIP_MODEL *model)
+{
+    CSIP_CALL(freeTransform(model));
+
+    if (SCIPgetObjsense(model->scip) != SCIP_OBJSENSE_MAXIMIZE)
+    {
+        SCIP_in_CSIP(SCIPsetObjsense(model->scip, SCIP_OBJSENSE_MAXIMIZE));
+        CSIP_CALL(correctObjectiveFunction(model));
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+/* value of objvar in the given solution, i.e., the value of the nonlinear
+ * objective function, which is coef * f(x) in the objective constraint
+ * coef * f(x) - objvar <= 0. The last point is kept, so that solving again
+ * from the same initial solution does not evaluate again.
+ */
+static
+CSIP_RETCODE evalObjvar(CSIP_MODEL *model, SCIP_SOL *sol, double *val,
+                        SCIP_Bool *valid)
+{
+    SCIP_EXPRTREE *tree = SCIPgetExprtreesNonlinear(model->scip,
+                          model->objcons)[0];
+    int ntreevars = SCIPexprtreeGetNVars(tree);
+    double *point;
+    SCIP_Bool samepoint;
+
+    point = (double *) malloc(MAX(ntreevars, 1) * sizeof(double));
+    if (point == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    SCIP_in_CSIP(SCIPgetSolVals(model->scip, sol, ntreevars,
+                                SCIPexprtreeGetVars(tree), point));
+
+    samepoint = model->hasobjpoint;
+    for (int i = 0; i < ntreevars && samepoint; ++i)
+    {
+        samepoint = (point[i] == model->objpoint[i]);
+    }
+
+    if (!samepoint)
+    {
+        SCIP_in_CSIP(SCIPexprtreeEval(tree, point, &model->objpointval));
+        model->objpointval *= SCIPgetExprtreeCoefsNonlinear(model->scip,
+                              model->objcons)[0];
+
+        // keep the point, the buffer is taken over by the model
+        free(model->objpoint);
+        model->objpoint = point;
+        model->hasobjpoint = TRUE;
+    }
+    else
+    {
+        free(point);
+    }
+
+    *val = model->objpointval;
+    *valid = SCIPisFinite(*val);
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsolve(CSIP_MODEL *model)
+{
+    unsigned long long fingerprint = 0;
+    SCIP_Bool usecache;
+
+    // drop the fixings of a previous CSIPsolveWithFixings
+    if (model->tempfixings)
+    {
+        SCIP_in_CSIP(SCIPfreeTransform(model->scip));
+        model->tempfixings = FALSE;
+    }
+
+    // look for a solution of an identical model, unless nothing has changed
+    usecache = (model->cache != NULL
+                && SCIPgetStage(model->scip) == SCIP_STAGE_PROBLEM);
+    if (usecache)
+    {
+        CSIP_RETCODE retcode = CSIPgetFingerprint(model, &fingerprint);
+
+        if (retcode != CSIP_RETCODE_OK)
+        {
+            return retcode;
+        }
+        if (model->ninitialsols == 0)
+        {
+            CSIP_CALL(useCachedSolution(model, fingerprint));
+        }
+    }
+
+    // statistics of our callbacks refer to the last solve only
+    model->nlazycalls = 0;
+    model->nheurcalls = 0;
+    SCIP_in_CSIP(SCIPresetClock(model->scip, model->lazyclock));
+    SCIP_in_CSIP(SCIPresetClock(model->scip, model->heurclock));
+
+    // add initial solutions
+    for (int i = 0; i < model->ninitialsols; ++i)
+    {
+        SCIP_SOL *initialsol = model->initialsols[i];
+        unsigned int stored;
+        SCIP_Bool initialsolpartial =
+            (SCIPsolGetOrigin(initialsol) == SCIP_SOLORIGIN_PARTIAL);
+
+        /* if objective is nonlinear, we need to extend the initial sol with
+         * the value of objvar.
+         *
+         * This is not true if the user has given a partial sol, because then
+         * we can safely leave the value for the objval unspecified. In fact,
+         * that's preferred, because the evaluation might fail.
+         */
+        if (model->objcons != NULL && !initialsolpartial)
+        {
+            SCIP_Real objvarval;
+            SCIP_Bool valid;
+
+            CSIP_CALL(evalObjvar(model, initialsol, &objvarval, &valid));
+            if (valid)
+            {
+                SCIP_in_CSIP(SCIPsetSolVals(model->scip, initialsol, 1,
+                         &model->objvar, &objvarval));
+            }
+        }
+
+
+        SCIP_in_CSIP(SCIPaddSolFree(model->scip, &initialsol, &stored));
+    }
+    model->ninitialsols = 0;
+
+    CSIP_CALL(addModelCons(model));
+    SCIP_in_CSIP(SCIPsolve(model->scip));
+
+    // write out buffered messages
+    flushMessages(model);
+
+    if (usecache)
+    {
+        CSIP_CALL(storeCachedSolution(model, fingerprint));
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+/* the fixings are global bound changes in the transformed problem only, so
+ * the original bounds stay as they are. The transformed problem is freed by the
+ * next change of the model or the next solve.
+ */
+CSIP_RETCODE CSIPsolveWithFixings(CSIP_MODEL *model, int numindices,
+                                  int *indices, double *values)
+{
+    SCIP *scip = model->scip;
+
+    for (int i = 0; i < numindices; ++i)
+    {
+        SCIP_VAR *var;
+
+        if (indices[i] < 0 || indices[i] >= model->nvars)
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+        var = model->vars[indices[i]];
+        if (values[i] < SCIPvarGetLbOriginal(var)
+                || values[i] > SCIPvarGetUbOriginal(var)
+                || (SCIPvarGetType(var) != SCIP_VARTYPE_CONTINUOUS
+                    && !SCIPisIntegral(scip, values[i])))
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+    }
+
+    SCIP_in_CSIP(SCIPfreeTransform(scip));
+    model->tempfixings = FALSE;
+    SCIP_in_CSIP(SCIPtransformProb(scip));
+
+    for (int i = 0; i < numindices; ++i)
+    {
+        SCIP_VAR *transvar;
+
+        SCIP_in_CSIP(SCIPgetTransformedVar(scip, model->vars[indices[i]],
+                                           &transvar));
+        SCIP_in_CSIP(SCIPchgVarLbGlobal(scip, transvar, values[i]));
+        SCIP_in_CSIP(SCIPchgVarUbGlobal(scip, transvar, values[i]));
+    }
+
+    CSIP_CALL(CSIPsolve(model));
+    model->tempfixings = TRUE;
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsolveLexicographic(CSIP_MODEL *model, int nobjs, int *begin,
+                                    int *indices, double *coefs,
+                                    double *tolerances, double *objvalues,
+                                    int *considx)
+{
+    SCIP_Bool maximize;
+    double *values;
+
+    maximize = (SCIPgetObjsense(model->scip) == SCIP_OBJSENSE_MAXIMIZE);
+    values = (double *) malloc(model->nvars * sizeof(double));
+    if (model->nvars > 0 && values == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    if (considx != NULL)
+    {
+        for (int k = 0; k < nobjs - 1; ++k)
+        {
+            considx[k] = -1;
+        }
+    }
+
+    for (int k = 0; k < nobjs; ++k)
+    {
+        int nterms = begin[k + 1] - begin[k];
+
+        if (k > 0)
+        {
+            // keep the previous objective within its tolerance of the optimum
+            int prevterms = begin[k] - begin[k - 1];
+            double bound = CSIPgetObjValue(model);
+            double tol = tolerances != NULL ? tolerances[k - 1] : 0.0;
+
+            CSIP_CALL(CSIPgetVarValues(model, values));
+            CSIP_CALL(CSIPaddLinCons(model, prevterms, indices + begin[k - 1],
+                                     coefs + begin[k - 1],
+                                     maximize ? bound - tol
+                                     : -SCIPinfinity(model->scip),
+                                     maximize ? SCIPinfinity(model->scip)
+                                     : bound + tol,
+                                     considx != NULL ? &considx[k - 1] : NULL));
+        }
+
+        CSIP_CALL(CSIPclearObj(model));
+        CSIP_CALL(CSIPsetObj(model, nterms, indices + begin[k], coefs + begin[k]));
+
+        // the previous solution is feasible, so use it as a start
+        if (k > 0)
+        {
+            CSIP_CALL(CSIPsetInitialSolution(model, values));
+        }
+
+        CSIP_CALL(CSIPsolve(model));
+        if (CSIPgetStatus(model) != CSIP_STATUS_OPTIMAL)
+        {
+            break;
+        }
+        if (objvalues != NULL)
+        {
+            objvalues[k] = CSIPgetObjValue(model);
+        }
+    }
+
+    free(values);
+
+    return CSIP_RETCODE_OK;
+}
+
+/*
+ * scenarios
+ */
+
+// whether scenarios can change the sides of a constraint
+static
+SCIP_Bool hasSides(SCIP_CONS *cons)
+{
+    const char *hdlrname = SCIPconshdlrGetName(SCIPconsGetHdlr(cons));
+
+    return strcmp(hdlrname, "linear") == 0
+           || strcmp(hdlrname, "quadratic") == 0;
+}
+
+// whether all indices of a scenario are valid, checked before solving any
+static
+SCIP_Bool isValidScenario(CSIP_MODEL *model, const CSIP_SCENARIO *scenario)
+{
+    if (scenario->nconss < 0 || scenario->nvars < 0)
+    {
+        return FALSE;
+    }
+    for (int i = 0; i < scenario->nconss; ++i)
+    {
+        int idx = scenario->consindices[i];
+
+        if (idx < 0 || idx >= model->nconss || !hasSides(model->conss[idx]))
+        {
+            return FALSE;
+        }
+    }
+    for (int i = 0; i < scenario->nvars; ++i)
+    {
+        if (scenario->varindices[i] < 0
+                || scenario->varindices[i] >= model->nvars)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static
+CSIP_RETCODE getConsSides(CSIP_MODEL *model, int idx, double *lhs, double *rhs)
+{
+    SCIP_CONS *cons = model->conss[idx];
+    const char *hdlrname = SCIPconshdlrGetName(SCIPconsGetHdlr(cons));
+
+    if (strcmp(hdlrname, "linear") == 0)
+    {
+        *lhs = SCIPgetLhsLinear(model->scip, cons);
+        *rhs = SCIPgetRhsLinear(model->scip, cons);
+    }
+    else if (strcmp(hdlrname, "quadratic") == 0)
+    {
+        *lhs = SCIPgetLhsQuadratic(model->scip, cons);
+        *rhs = SCIPgetRhsQuadratic(model->scip, cons);
+    }
+    else
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+// the sides are changed in an order that keeps lhs <= rhs
+static
+CSIP_RETCODE chgConsSides(CSIP_MODEL *model, int idx, double lhs, double rhs)
+{
+    SCIP *scip = model->scip;
+    SCIP_CONS *cons = model->conss[idx];
+    SCIP_Bool linear;
+    SCIP_RETCODE lhsretcode;
+    SCIP_RETCODE rhsretcode;
+    double oldlhs;
+    double oldrhs;
+    CSIP_RETCODE retcode;
+
+    retcode = getConsSides(model, idx, &oldlhs, &oldrhs);
+    if (retcode != CSIP_RETCODE_OK)
+    {
+        return retcode;
+    }
+    linear = (strcmp(SCIPconshdlrGetName(SCIPconsGetHdlr(cons)), "linear") == 0);
+
+    if (lhs > oldrhs)
+    {
+        rhsretcode = linear ? SCIPchgRhsLinear(scip, cons, rhs)
+                     : SCIPchgRhsQuadratic(scip, cons, rhs);
+        lhsretcode = linear ? SCIPchgLhsLinear(scip, cons, lhs)
+                     : SCIPchgLhsQuadratic(scip, cons, lhs);
+    }
+    else
+    {
+        lhsretcode = linear ? SCIPchgLhsLinear(scip, cons, lhs)
+                     : SCIPchgLhsQuadratic(scip, cons, lhs);
+        rhsretcode = linear ? SCIPchgRhsLinear(scip, cons, rhs)
+                     : SCIPchgRhsQuadratic(scip, cons, rhs);
+    }
+
+    retcode = retCodeSCIPtoCSIP(lhsretcode);
+    return retcode != CSIP_RETCODE_OK ? retcode
+           : retCodeSCIPtoCSIP(rhsretcode);
+}
+
+/* apply the changes of a valid scenario to the model; if saved is given, the
+ * current values are stored in it first, such that applying saved restores
+ * the model
+ */
+static
+CSIP_RETCODE applyScenario(CSIP_MODEL *model, CSIP_SCENARIO *scenario,
+                           CSIP_SCENARIO *saved)
+{
+    SCIP *scip = model->scip;
+    CSIP_RETCODE retcode;
+
+    retcode = freeTransform(model);
+
+    for (int i = 0; saved != NULL && retcode == CSIP_RETCODE_OK
+            && i < scenario->nconss; ++i)
+    {
+        retcode = getConsSides(model, scenario->consindices[i],
+                               &saved->lhss[i], &saved->rhss[i]);
+    }
+    for (int i = 0; saved != NULL && i < scenario->nvars; ++i)
+    {
+        SCIP_VAR *var = model->vars[scenario->varindices[i]];
+
+        saved->lbs[i] = SCIPvarGetLbOriginal(var);
+        saved->ubs[i] = SCIPvarGetUbOriginal(var);
+    }
+
+    for (int i = 0; retcode == CSIP_RETCODE_OK && i < scenario->nconss; ++i)
+    {
+        retcode = chgConsSides(model, scenario->consindices[i],
+                               scenario->lhss[i], scenario->rhss[i]);
+    }
+
+    for (int i = 0; retcode == CSIP_RETCODE_OK && i < scenario->nvars; ++i)
+    {
+        SCIP_VAR *var = model->vars[scenario->varindices[i]];
+
+        if (scenario->lbs[i] > SCIPvarGetUbOriginal(var))
+        {
+            retcode = retCodeSCIPtoCSIP(SCIPchgVarUb(scip, var,
+                                        scenario->ubs[i]));
+            if (retcode == CSIP_RETCODE_OK)
+            {
+                retcode = retCodeSCIPtoCSIP(SCIPchgVarLb(scip, var,
+                                            scenario->lbs[i]));
+            }
+        }
+        else
+        {
+            retcode = retCodeSCIPtoCSIP(SCIPchgVarLb(scip, var,
+                                        scenario->lbs[i]));
+            if (retcode == CSIP_RETCODE_OK)
+            {
+                retcode = retCodeSCIPtoCSIP(SCIPchgVarUb(scip, var,
+                                            scenario->ubs[i]));
+            }
+        }
+    }
+
+    return retcode;
+}
+
+static inline
+double valueDistance(SCIP *scip, double a, double b)
+{
+    if (a == b)
+    {
+        return 0.0;
+    }
+    if (SCIPisInfinity(scip, fabs(a)) || SCIPisInfinity(scip, fabs(b)))
+    {
+        return 1.0;
+    }
+    return fabs(a - b);
+}
+
+// distance of a scenario to the current state of the model
+static
+CSIP_RETCODE scenarioDistance(CSIP_MODEL *model, CSIP_SCENARIO *scenario,
+                              double *distance)
+{
+    SCIP *scip = model->scip;
+
+    *distance = 0.0;
+    for (int i = 0; i < scenario->nconss; ++i)
+    {
+        double lhs;
+        double rhs;
+        CSIP_RETCODE retcode;
+
+        retcode = getConsSides(model, scenario->consindices[i], &lhs, &rhs);
+        if (retcode != CSIP_RETCODE_OK)
+        {
+            return retcode;
+        }
+        *distance += valueDistance(scip, scenario->lhss[i], lhs)
+                     + valueDistance(scip, scenario->rhss[i], rhs);
+    }
+    for (int i = 0; i < scenario->nvars; ++i)
+    {
+        SCIP_VAR *var = model->vars[scenario->varindices[i]];
+
+        *distance += valueDistance(scip, scenario->lbs[i],
+                                   SCIPvarGetLbOriginal(var))
+                     + valueDistance(scip, scenario->ubs[i],
+                                     SCIPvarGetUbOriginal(var));
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+/* scenarios that are solved by several models at once; each model claims the
+ * next scenario while holding the mutex */
+typedef struct
+{
+    int nscenarios;
+    CSIP_SCENARIO *scenarios;
+    SCIP_Bool *claimed;
+    pthread_mutex_t mutex;
+    int nsolindices;
+    int *solindices;
+    CSIP_STATUS *statuses;
+    double *objvalues;
+    double *solvalues;
+} CSIP_SCENARIOPOOL;
+
+/* claim an unsolved scenario, or set s to -1 if there is none. With nearest,
+ * it is the one that changes least with respect to the current state of the
+ * model, so that the solution of the model is a good start; otherwise, the
+ * first one.
+ */
+static
+CSIP_RETCODE claimScenario(CSIP_MODEL *model, CSIP_SCENARIOPOOL *pool,
+                           SCIP_Bool nearest, int *s)
+{
+    CSIP_RETCODE retcode = CSIP_RETCODE_OK;
+    double mindistance = SCIPinfinity(model->scip);
+
+    pthread_mutex_lock(&pool->mutex);
+
+    *s = -1;
+    for (int t = 0; t < pool->nscenarios; ++t)
+    {
+        double distance;
+
+        if (pool->claimed[t])
+        {
+            continue;
+        }
+        if (!nearest)
+        {
+            *s = t;
+            break;
+        }
+        retcode = scenarioDistance(model, &pool->scenarios[t], &distance);
+        if (retcode != CSIP_RETCODE_OK)
+        {
+            *s = -1;
+            break;
+        }
+        if (distance < mindistance || *s == -1)
+        {
+            mindistance = distance;
+            *s = t;
+        }
+    }
+    if (*s >= 0)
+    {
+        pool->claimed[*s] = TRUE;
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return retcode;
+}
+
+// solve scenarios of the pool with the model until all are claimed
+static
+CSIP_RETCODE solveScenarioPool(CSIP_MODEL *model, CSIP_SCENARIOPOOL *pool)
+{
+    CSIP_SCENARIO saved;
+    SCIP_Bool hassol = FALSE;
+    double *values;
+    int maxnconss = 0;
+    int maxnvars = 0;
+    int s;
+    CSIP_RETCODE retcode;
+
+    for (int t = 0; t < pool->nscenarios; ++t)
+    {
+        maxnconss = MAX(maxnconss, pool->scenarios[t].nconss);
+        maxnvars = MAX(maxnvars, pool->scenarios[t].nvars);
+    }
+
+    saved.lhss = (double *) malloc(MAX(maxnconss, 1) * sizeof(double));
+    saved.rhss = (double *) malloc(MAX(maxnconss, 1) * sizeof(double));
+    saved.lbs = (double *) malloc(MAX(maxnvars, 1) * sizeof(double));
+    saved.ubs = (double *) malloc(MAX(maxnvars, 1) * sizeof(double));
+    values = (double *) malloc(MAX(model->nvars, 1) * sizeof(double));
+    retcode = (saved.lhss == NULL || saved.rhss == NULL || saved.lbs == NULL
+               || saved.ubs == NULL || values == NULL)
+              ? CSIP_RETCODE_NOMEMORY : CSIP_RETCODE_OK;
+
+    s = -1;
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = claimScenario(model, pool, FALSE, &s);
+    }
+    while (retcode == CSIP_RETCODE_OK && s >= 0)
+    {
+        CSIP_SCENARIO *scenario = &pool->scenarios[s];
+        CSIP_RETCODE restored;
+        int next = -1;
+
+        saved.nconss = scenario->nconss;
+        saved.consindices = scenario->consindices;
+        saved.nvars = scenario->nvars;
+        saved.varindices = scenario->varindices;
+        retcode = applyScenario(model, scenario, &saved);
+
+        // start from the solution of the previous scenario
+        if (retcode == CSIP_RETCODE_OK && hassol)
+        {
+            retcode = CSIPsetInitialSolution(model, values);
+        }
+        if (retcode == CSIP_RETCODE_OK)
+        {
+            retcode = CSIPsolve(model);
+        }
+
+        // each scenario is claimed once, so its results are ours to write
+        if (retcode == CSIP_RETCODE_OK)
+        {
+            pool->statuses[s] = CSIPgetStatus(model);
+            hassol = (SCIPgetBestSol(model->scip) != NULL);
+            if (hassol)
+            {
+                retcode = CSIPgetVarValues(model, values);
+            }
+        }
+        if (retcode == CSIP_RETCODE_OK && pool->objvalues != NULL)
+        {
+            pool->objvalues[s] = hassol ? CSIPgetObjValue(model) : NAN;
+        }
+        for (int j = 0; retcode == CSIP_RETCODE_OK && pool->solvalues != NULL
+                && j < pool->nsolindices; ++j)
+        {
+            pool->solvalues[s * pool->nsolindices + j] =
+                hassol ? values[pool->solindices[j]] : NAN;
+        }
+
+        // the distances refer to the solved scenario
+        if (retcode == CSIP_RETCODE_OK)
+        {
+            retcode = claimScenario(model, pool, hassol, &next);
+        }
+
+        // the saved values are complete, since scenarios are valid
+        restored = applyScenario(model, &saved, NULL);
+        if (retcode == CSIP_RETCODE_OK)
+        {
+            retcode = restored;
+        }
+        s = next;
+    }
+
+    free(saved.lhss);
+    free(saved.rhss);
+    free(saved.lbs);
+    free(saved.ubs);
+    free(values);
+
+    return retcode;
+}
+
+/* create a copy of a model without callbacks, to solve scenarios in another
+ * thread. It is not valid if a variable or constraint could not be copied, as
+ * is the case for inactive constraints.
+ */
+static
+CSIP_RETCODE cloneModel(CSIP_MODEL *source, CSIP_MODEL **cloneptr,
+                        SCIP_Bool *valid)
+{
+    CSIP_MODEL *clone;
+    SCIP_HASHMAP *varmap;
+    SCIP_HASHMAP *consmap;
+
+    *cloneptr = (CSIP_MODEL *) malloc(sizeof(CSIP_MODEL));
+    if (*cloneptr == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    clone = *cloneptr;
+
+    // the message handler of the model is not shared with other threads
+    SCIP_in_CSIP(SCIPcreate(&clone->scip));
+    SCIP_in_CSIP(SCIPhashmapCreate(&varmap, SCIPblkmem(clone->scip),
+                                   MAX(source->nvars, 1)));
+    SCIP_in_CSIP(SCIPhashmapCreate(&consmap, SCIPblkmem(clone->scip),
+                                   MAX(source->nconss, 1)));
+    SCIP_in_CSIP(SCIPcopyOrig(source->scip, clone->scip, varmap, consmap, "",
+                              FALSE, TRUE, FALSE, valid));
+    SCIPsetMessagehdlrQuiet(clone->scip, TRUE);
+
+    CSIP_CALL(initModel(clone));
+
+    clone->varssize = MAX(source->nvars, INITIALSIZE);
+    clone->vars = (SCIP_VAR **) realloc(
+                      clone->vars, clone->varssize * sizeof(SCIP_VAR *));
+    clone->consssize = MAX(source->nconss, INITIALSIZE);
+    clone->conss = (SCIP_CONS **) realloc(
+                       clone->conss, clone->consssize * sizeof(SCIP_CONS *));
+    clone->consactive = (SCIP_Bool *) realloc(
+                            clone->consactive,
+                            clone->consssize * sizeof(SCIP_Bool));
+    if (clone->vars == NULL || clone->conss == NULL
+            || clone->consactive == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    // the clone holds a reference to each, as models do for their own
+    for (int i = 0; i < source->nvars && *valid; ++i)
+    {
+        SCIP_VAR *var = (SCIP_VAR *) SCIPhashmapGetImage(varmap,
+                        source->vars[i]);
+
+        *valid = (var != NULL);
+        if (*valid)
+        {
+            SCIP_in_CSIP(SCIPcaptureVar(clone->scip, var));
+            clone->vars[clone->nvars] = var;
+            ++(clone->nvars);
+        }
+    }
+    for (int i = 0; i < source->nconss && *valid; ++i)
+    {
+        SCIP_CONS *cons = (SCIP_CONS *) SCIPhashmapGetImage(consmap,
+                          source->conss[i]);
+
+        *valid = (cons != NULL);
+        if (*valid)
+        {
+            SCIP_in_CSIP(SCIPcaptureCons(clone->scip, cons));
+            clone->conss[clone->nconss] = cons;
+            clone->consactive[clone->nconss] = TRUE;
+            ++(clone->nconss);
+        }
+    }
+    if (*valid && source->objvar != NULL)
+    {
+        SCIP_VAR *objvar = (SCIP_VAR *) SCIPhashmapGetImage(varmap,
+                           source->objvar);
+        SCIP_CONS *objcons = (SCIP_CONS *) SCIPhashmapGetImage(consmap,
+                             source->objcons);
+
+        *valid = (objvar != NULL && objcons != NULL);
+        if (*valid)
+        {
+            SCIP_in_CSIP(SCIPcaptureVar(clone->scip, objvar));
+            SCIP_in_CSIP(SCIPcaptureCons(clone->scip, objcons));
+            clone->objvar = objvar;
+            clone->objcons = objcons;
+            clone->objtype = source->objtype;
+        }
+    }
+
+    SCIPhashmapFree(&consmap);
+    SCIPhashmapFree(&varmap);
+
+    return CSIP_RETCODE_OK;
+}
+
+// a thread solving scenarios with its own copy of the model
+typedef struct
+{
+    CSIP_MODEL *model;
+    CSIP_SCENARIOPOOL *pool;
+    pthread_t thread;
+    CSIP_RETCODE retcode;
+} CSIP_SCENARIOWORKER;
+
+static
+void *scenarioWorker(void *data)
+{
+    CSIP_SCENARIOWORKER *worker = (CSIP_SCENARIOWORKER *) data;
+
+    worker->retcode = solveScenarioPool(worker->model, worker->pool);
+
+    return NULL;
+}
+
+/* Models without callbacks are copied once per additional processor, and the
+ * copies solve scenarios in threads next to the model itself. User callbacks
+ * are not copied, since they might not be safe to call concurrently, so such
+ * models solve all scenarios by themselves.
+ */
+CSIP_RETCODE CSIPsolveScenarios(CSIP_MODEL *model, int nscenarios,
+                                CSIP_SCENARIO *scenarios, int nsolindices,
+                                int *solindices, CSIP_STATUS *statuses,
+                                double *objvalues, double *solvalues)
+{
+    CSIP_SCENARIOPOOL pool;
+    CSIP_SCENARIOWORKER *workers;
+    CSIP_RETCODE retcode;
+    int nworkers = 1;
+
+    // reject invalid input before any scenario is solved
+    for (int t = 0; t < nscenarios; ++t)
+    {
+        if (!isValidScenario(model, &scenarios[t]))
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+    }
+    for (int j = 0; j < nsolindices; ++j)
+    {
+        if (solindices[j] < 0 || solindices[j] >= model->nvars)
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+    }
+
+    pool.nscenarios = nscenarios;
+    pool.scenarios = scenarios;
+    pool.claimed = (SCIP_Bool *) calloc(MAX(nscenarios, 1), sizeof(SCIP_Bool));
+    pool.nsolindices = nsolindices;
+    pool.solindices = solindices;
+    pool.statuses = statuses;
+    pool.objvalues = objvalues;
+    pool.solvalues = solvalues;
+    if (pool.claimed == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    if (pthread_mutex_init(&pool.mutex, NULL) != 0)
+    {
+        free(pool.claimed);
+        return CSIP_RETCODE_ERROR;
+    }
+
+    if (model->nlazycb == 0 && model->nheur == 0 && model->neventhdlr == 0)
+    {
+        long nprocs = sysconf(_SC_NPROCESSORS_ONLN);
+        nworkers = (int) MAX(MIN(nprocs, nscenarios), 1);
+    }
+    workers = (CSIP_SCENARIOWORKER *) malloc(nworkers
+              * sizeof(CSIP_SCENARIOWORKER));
+    if (workers == NULL)
+    {
+        pthread_mutex_destroy(&pool.mutex);
+        free(pool.claimed);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    // copy the original problem, not a transformed one with old changes
+    SCIP_in_CSIP(SCIPfreeTransform(model->scip));
+    model->tempfixings = FALSE;
+
+    // the model itself is the first worker, in this thread
+    workers[0].model = model;
+    workers[0].pool = &pool;
+    for (int w = 1; w < nworkers; ++w)
+    {
+        SCIP_Bool valid;
+
+        workers[w].pool = &pool;
+        CSIP_CALL(cloneModel(model, &workers[w].model, &valid));
+        if (!valid || pthread_create(&workers[w].thread, NULL, scenarioWorker,
+                                     &workers[w]) != 0)
+        {
+            CSIP_CALL(CSIPfreeModel(workers[w].model));
+            nworkers = w;
+            break;
+        }
+    }
+
+    retcode = solveScenarioPool(model, &pool);
+
+    for (int w = 1; w < nworkers; ++w)
+    {
+        pthread_join(workers[w].thread, NULL);
+        if (retcode == CSIP_RETCODE_OK)
+        {
+            retcode = workers[w].retcode;
+        }
+        CSIP_CALL(CSIPfreeModel(workers[w].model));
+    }
+
+    pthread_mutex_destroy(&pool.mutex);
+    free(workers);
+    free(pool.claimed);
+
+    return retcode;
+}
+
+CSIP_RETCODE CSIPinterrupt(CSIP_MODEL *model)
+{
+    SCIP_in_CSIP(SCIPinterruptSolve(model->scip));
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_STATUS CSIPgetStatus(CSIP_MODEL *model)
+{
+    switch (SCIPgetStatus(model->scip))
+    {
+    case SCIP_STATUS_UNKNOWN:
+        return CSIP_STATUS_UNKNOWN;
+    case SCIP_STATUS_USERINTERRUPT:
+        return CSIP_STATUS_USERLIMIT;
+    case SCIP_STATUS_NODELIMIT:
+        return CSIP_STATUS_NODELIMIT;
+    case SCIP_STATUS_TOTALNODELIMIT:
+        return CSIP_STATUS_NODELIMIT;
+    case SCIP_STATUS_STALLNODELIMIT:
+        return CSIP_STATUS_USERLIMIT;
+    case SCIP_STATUS_TIMELIMIT:
+        return CSIP_STATUS_TIMELIMIT;
+    case SCIP_STATUS_MEMLIMIT:
+        return CSIP_STATUS_MEMLIMIT;
+    case SCIP_STATUS_GAPLIMIT:
+        return CSIP_STATUS_USERLIMIT;
+    case SCIP_STATUS_SOLLIMIT:
+        return CSIP_STATUS_USERLIMIT;
+    case SCIP_STATUS_BESTSOLLIMIT:
+        return CSIP_STATUS_USERLIMIT;
+    case SCIP_STATUS_RESTARTLIMIT:
+        return CSIP_STATUS_USERLIMIT;
+    case SCIP_STATUS_OPTIMAL:
+        return CSIP_STATUS_OPTIMAL;
+    case SCIP_STATUS_INFEASIBLE:
+        return CSIP_STATUS_INFEASIBLE;
+    case SCIP_STATUS_UNBOUNDED:
+        return CSIP_STATUS_UNBOUNDED;
+    case SCIP_STATUS_INFORUNBD:
+        return CSIP_STATUS_INFORUNBD;
+    default:
+        return CSIP_STATUS_UNKNOWN;
+    }
+}
+
+double CSIPgetObjValue(CSIP_MODEL *model)
+{
+    SCIP_SOL *sol = SCIPgetBestSol(model->scip);
+    if (sol == NULL)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    return SCIPgetSolOrigObj(model->scip, sol);
+}
+
+double CSIPgetObjBound(CSIP_MODEL *model)
+{
+    return SCIPgetDualbound(model->scip);
+}
+
+
+CSIP_RETCODE CSIPgetVarValues(CSIP_MODEL *model, double *output)
+{
+    int i;
+    SCIP *scip;
+    SCIP_VAR *var;
+
+    scip = model->scip;
+
+    if (SCIPgetBestSol(scip) == NULL)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    for (i = 0; i < model->nvars; ++i)
+    {
+        var = model->vars[i];
+        output[i] = SCIPgetSolVal(scip, SCIPgetBestSol(scip), var);
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPgetSolveStats(CSIP_MODEL *model, CSIP_SOLVESTATS *stats)
+{
+    SCIP *scip = model->scip;
+    SCIP_SEPA **sepas;
+    SCIP_HEUR **heurs;
+    int nsepas;
+    int nheurs;
+
+    // statistics are only available after solving
+    if (SCIPgetStage(scip) < SCIP_STAGE_TRANSFORMED)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    stats->presolvingtime = SCIPgetPresolvingTime(scip);
+    stats->rootlptime = SCIPgetFirstLPTime(scip);
+    stats->solvingtime = SCIPgetSolvingTime(scip);
+    stats->nlpiterations = SCIPgetNLPIterations(scip);
+    stats->nnodes = SCIPgetNNodes(scip);
+    stats->maxdepth = SCIPgetMaxDepth(scip);
+    stats->ncutsapplied = SCIPgetNCutsApplied(scip);
+
+    stats->nlazycalls = model->nlazycalls;
+    stats->lazytime = SCIPgetClockTime(scip, model->lazyclock);
+    stats->nheurcalls = model->nheurcalls;
+    stats->heurtime = SCIPgetClockTime(scip, model->heurclock);
+
+    // per-plugin statistics, the names are owned by SCIP
+    sepas = SCIPgetSepas(scip);
+    nsepas = SCIPgetNSepas(scip);
+    model->sepanames = (const char **) realloc(
+                           model->sepanames, nsepas * sizeof(const char *));
+    model->sepancuts = (long long *) realloc(
+                           model->sepancuts, nsepas * sizeof(long long));
+    if (nsepas > 0 && (model->sepanames == NULL || model->sepancuts == NULL))
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    for (int i = 0; i < nsepas; ++i)
+    {
+        model->sepanames[i] = SCIPsepaGetName(sepas[i]);
+        model->sepancuts[i] = SCIPsepaGetNCutsFound(sepas[i]);
+    }
+
+    heurs = SCIPgetHeurs(scip);
+    nheurs = SCIPgetNHeurs(scip);
+    model->heurnames = (const char **) realloc(
+                           model->heurnames, nheurs * sizeof(const char *));
+    model->heurtimes = (double *) realloc(
+                           model->heurtimes, nheurs * sizeof(double));
+    if (nheurs > 0 && (model->heurnames == NULL || model->heurtimes == NULL))
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    for (int i = 0; i < nheurs; ++i)
+    {
+        model->heurnames[i] = SCIPheurGetName(heurs[i]);
+        model->heurtimes[i] = SCIPheurGetTime(heurs[i]);
+    }
+
+    stats->nsepas = nsepas;
+    stats->sepanames = model->sepanames;
+    stats->sepancuts = model->sepancuts;
+    stats->nheurs = nheurs;
+    stats->heurnames = model->heurnames;
+    stats->heurtimes = model->heurtimes;
+
+    return CSIP_RETCODE_OK;
+}
+
+// Get the type of a parameter
+CSIP_PARAMTYPE CSIPgetParamType(CSIP_MODEL *model, const char *name)
+{
+    SCIP_PARAM *param;
+
+    param = SCIPgetParam(model->scip, name);
+    if (param == NULL)
+    {
+        return CSIP_PARAMTYPE_NOTAPARAM;
+    }
+    else
+    {
+        return SCIPparamGetType(param);
+    }
+}
+
+CSIP_RETCODE CSIPsetBoolParam(
+    CSIP_MODEL *model, const char *name, int value)
+{
+    SCIP_in_CSIP(SCIPsetBoolParam(model->scip, name, value));
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetIntParam(
+    CSIP_MODEL *model, const char *name, int value)
+{
+    SCIP_in_CSIP(SCIPsetIntParam(model->scip, name, value));
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetLongintParam(
+    CSIP_MODEL *model, const char *name, long long value)
+{
+    SCIP_in_CSIP(SCIPsetLongintParam(model->scip, name, value));
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetRealParam(
+    CSIP_MODEL *model, const char *name, double value)
+{
+    SCIP_in_CSIP(SCIPsetRealParam(model->scip, name, value));
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetCharParam(
+    CSIP_MODEL *model, const char *name, char value)
+{
+    SCIP_in_CSIP(SCIPsetCharParam(model->scip, name, value));
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetStringParam(
+    CSIP_MODEL *model, const char *name, const char *value)
+{
+    SCIP_in_CSIP(SCIPsetStringParam(model->scip, name, value));
+    return CSIP_RETCODE_OK;
+}
+
+int CSIPgetNumVars(CSIP_MODEL *model)
+{
+    return model->nvars;
+}
+
+int CSIPgetNumConss(CSIP_MODEL *model)
+{
+    return model->nconss;
+}
+
+// mark the entities to delete among n, checking the indices
+static
+CSIP_RETCODE getDeleteMask(int n, int numindices, int *indices,
+                           SCIP_Bool **deleted)
+{
+    *deleted = (SCIP_Bool *) calloc(MAX(n, 1), sizeof(SCIP_Bool));
+    if (*deleted == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    for (int i = 0; i < numindices; ++i)
+    {
+        if (indices[i] < 0 || indices[i] >= n)
+        {
+            free(*deleted);
+            return CSIP_RETCODE_ERROR;
+        }
+        (*deleted)[indices[i]] = TRUE;
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+// size of an array holding n entries, shrunk when it has become sparse
+static
+int shrinkSize(int n, int size)
+{
+    while (size / GROWFACTOR >= INITIALSIZE
+            && n * GROWFACTOR * GROWFACTOR <= size)
+    {
+        size /= GROWFACTOR;
+    }
+
+    return size;
+}
+
+/* whether a constraint other than a linear one uses a deleted variable; SCIP
+ * only removes deleted variables from linear constraints. The linear row of an
+ * indicator constraint counts as part of the indicator constraint.
+ */
+static
+CSIP_RETCODE consUsesDeletedVars(CSIP_MODEL *model, SCIP_CONS *cons,
+                                 const int *varindex, const SCIP_Bool *deleted,
+                                 SCIP_Bool *uses)
+{
+    SCIP *scip = model->scip;
+    const char *hdlrname = SCIPconshdlrGetName(SCIPconsGetHdlr(cons));
+    SCIP_CONS *row = getIndicatorRow(cons);
+    SCIP_VAR **vars;
+    SCIP_Bool success;
+    SCIP_RETCODE retcode;
+    int nvars;
+
+    *uses = FALSE;
+    if (strcmp(hdlrname, "linear") == 0)
+    {
+        return CSIP_RETCODE_OK;
+    }
+    if (row != NULL)
+    {
+        SCIP_VAR **rowvars = SCIPgetVarsLinear(scip, row);
+
+        for (int j = 0; j < SCIPgetNVarsLinear(scip, row) && !*uses; ++j)
+        {
+            int idx = varindex[SCIPvarGetProbindex(rowvars[j])];
+
+            *uses = (idx >= 0 && deleted[idx]);
+        }
+    }
+
+    // without the variables of the constraint, assume the worst
+    SCIP_in_CSIP(SCIPgetConsNVars(scip, cons, &nvars, &success));
+    if (!success)
+    {
+        *uses = TRUE;
+        return CSIP_RETCODE_OK;
+    }
+    vars = (SCIP_VAR **) malloc(MAX(nvars, 1) * sizeof(SCIP_VAR *));
+    if (vars == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    retcode = SCIPgetConsVars(scip, cons, vars, nvars, &success);
+    if (retcode != SCIP_OKAY)
+    {
+        free(vars);
+        return retCodeSCIPtoCSIP(retcode);
+    }
+    *uses = *uses || !success;
+    for (int j = 0; j < nvars && !*uses; ++j)
+    {
+        int idx = varindex[SCIPvarGetProbindex(vars[j])];
+
+        *uses = (idx >= 0 && deleted[idx]);
+    }
+    free(vars);
+
+    return CSIP_RETCODE_OK;
+}
+
+// whether constraints that CSIPdelVars cannot update use deleted variables
+static
+CSIP_RETCODE usesDeletedVars(CSIP_MODEL *model, const SCIP_Bool *deleted,
+                             SCIP_Bool *uses)
+{
+    CSIP_RETCODE retcode = CSIP_RETCODE_OK;
+    int *varindex;
+
+    *uses = FALSE;
+    CSIP_CALL(createVarIndexMap(model, &varindex));
+
+    // inactive constraints count, too, as they may be activated again
+    for (int i = 0; i < model->nconss && !*uses; ++i)
+    {
+        retcode = consUsesDeletedVars(model, model->conss[i], varindex, deleted,
+                                      uses);
+        if (retcode != CSIP_RETCODE_OK)
+        {
+            break;
+        }
+    }
+    if (retcode == CSIP_RETCODE_OK && !*uses && model->objcons != NULL)
+    {
+        retcode = consUsesDeletedVars(model, model->objcons, varindex, deleted,
+                                      uses);
+    }
+    free(varindex);
+
+    return retcode;
+}
+
+CSIP_RETCODE CSIPdelVars(CSIP_MODEL *model, int numindices, int *indices,
+                         int *newindices)
+{
+    SCIP *scip = model->scip;
+    SCIP_Bool *deleted;
+    SCIP_Bool used;
+    CSIP_RETCODE retcode;
+    int nvars = 0;
+
+    retcode = getDeleteMask(model->nvars, numindices, indices, &deleted);
+    if (retcode != CSIP_RETCODE_OK)
+    {
+        return retcode;
+    }
+
+    retcode = usesDeletedVars(model, deleted, &used);
+    if (retcode != CSIP_RETCODE_OK || used)
+    {
+        free(deleted);
+        return retcode != CSIP_RETCODE_OK ? retcode : CSIP_RETCODE_ERROR;
+    }
+
+    CSIP_CALL(freeTransform(model));
+
+    for (int i = 0; i < model->nvars; ++i)
+    {
+        if (deleted[i])
+        {
+            SCIP_Bool success;
+
+            SCIP_in_CSIP(SCIPdelVar(scip, model->vars[i], &success));
+            assert(success);
+            SCIP_in_CSIP(SCIPreleaseVar(scip, &model->vars[i]));
+            ++(model->ndelvars);
+        }
+        else
+        {
+            model->vars[nvars] = model->vars[i];
+            ++nvars;
+        }
+        if (newindices != NULL)
+        {
+            newindices[i] = deleted[i] ? -1 : nvars - 1;
+        }
+    }
+    free(deleted);
+    model->nvars = nvars;
+
+    if (shrinkSize(nvars, model->varssize) < model->varssize)
+    {
+        model->varssize = shrinkSize(nvars, model->varssize);
+        model->vars = (SCIP_VAR **) realloc(
+                          model->vars, model->varssize * sizeof(SCIP_VAR *));
+        if (model->vars == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+    }
+
+    // the indices have changed, the lookup is built again on first use
+    freeNameTable(&model->varnames);
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPdelConss(CSIP_MODEL *model, int numindices, int *indices,
+                          int *newindices)
+{
+    SCIP *scip = model->scip;
+    SCIP_Bool *deleted;
+    int *remap;
+    int nconss = 0;
+    CSIP_RETCODE retcode;
+
+    retcode = getDeleteMask(model->nconss, numindices, indices, &deleted);
+    if (retcode != CSIP_RETCODE_OK)
+    {
+        return retcode;
+    }
+    remap = (int *) malloc(MAX(model->nconss, 1) * sizeof(int));
+    if (remap == NULL)
+    {
+        free(deleted);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    CSIP_CALL(freeTransform(model));
+
+    for (int i = 0; i < model->nconss; ++i)
+    {
+        if (deleted[i])
+        {
+            SCIP_CONS *row = getIndicatorRow(model->conss[i]);
+
+            // inactive constraints are not in the problem anymore
+            if (model->consactive[i])
+            {
+                SCIP_in_CSIP(SCIPdelCons(scip, model->conss[i]));
+                if (row != NULL)
+                {
+                    SCIP_in_CSIP(SCIPdelCons(scip, row));
+                }
+            }
+            // the slack variable of an indicator constraint is not used else
+            if (row != NULL)
+            {
+                SCIP_Bool success;
+
+                SCIP_in_CSIP(SCIPdelVar(scip,
+                                        SCIPgetSlackVarIndicator(model->conss[i]),
+                                        &success));
+            }
+            SCIP_in_CSIP(SCIPreleaseCons(scip, &model->conss[i]));
+            ++(model->ndelconss);
+        }
+        else
+        {
+            model->conss[nconss] = model->conss[i];
+            model->consactive[nconss] = model->consactive[i];
+            ++nconss;
+        }
+        remap[i] = deleted[i] ? -1 : nconss - 1;
+    }
+    if (newindices != NULL)
+    {
+        memcpy(newindices, remap, model->nconss * sizeof(int));
+    }
+    model->nconss = nconss;
+
+    // keep the groups in terms of the new indices
+    for (int g = 0; g < model->ngroups; ++g)
+    {
+        CSIP_CONSGROUP *group = &model->groups[g];
+        int n = 0;
+
+        for (int j = 0; j < group->nconss; ++j)
+        {
+            int idx = group->conss[j];
+
+            if (!deleted[idx])
+            {
+                group->conss[n] = remap[idx];
+                ++n;
+            }
+        }
+        group->nconss = n;
+    }
+    free(remap);
+    free(deleted);
+
+    if (shrinkSize(nconss, model->consssize) < model->consssize)
+    {
+        model->consssize = shrinkSize(nconss, model->consssize);
+        model->conss = (SCIP_CONS **) realloc(
+                           model->conss, model->consssize * sizeof(SCIP_CONS *));
+        model->consactive = (SCIP_Bool *) realloc(
+                                model->consactive,
+                                model->consssize * sizeof(SCIP_Bool));
+        if (model->conss == NULL || model->consactive == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+    }
+
+    // the indices have changed, the lookup is built again on first use
+    freeNameTable(&model->consnames);
+
+    return CSIP_RETCODE_OK;
+}
+
+/* inactive constraints are deleted from the problem while the model keeps its
+ * reference, and added again when activated. SCIP keeps a constraint marked as
+ * deleted after it was added again, so the state is tracked in consactive. */
+CSIP_RETCODE CSIPsetConsActive(CSIP_MODEL *model, int numindices, int *indices,
+                               int active)
+{
+    SCIP *scip = model->scip;
+    SCIP_Bool changed = FALSE;
+
+    for (int i = 0; i < numindices; ++i)
+    {
+        if (indices[i] < 0 || indices[i] >= model->nconss)
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+        changed = changed
+                  || (model->consactive[indices[i]] != (active != 0));
+    }
+
+    // toggling to the current state keeps the transformed problem
+    if (!changed)
+    {
+        return CSIP_RETCODE_OK;
+    }
+
+    CSIP_CALL(freeTransform(model));
+
+    for (int i = 0; i < numindices; ++i)
+    {
+        int idx = indices[i];
+
+        SCIP_CONS *row = getIndicatorRow(model->conss[idx]);
+
+        if (active && !model->consactive[idx])
+        {
+            SCIP_in_CSIP(SCIPaddCons(scip, model->conss[idx]));
+            if (row != NULL)
+            {
+                SCIP_in_CSIP(SCIPaddCons(scip, row));
+            }
+            model->consactive[idx] = TRUE;
+        }
+        else if (!active && model->consactive[idx])
+        {
+            SCIP_in_CSIP(SCIPdelCons(scip, model->conss[idx]));
+            if (row != NULL)
+            {
+                SCIP_in_CSIP(SCIPdelCons(scip, row));
+            }
+            model->consactive[idx] = FALSE;
+        }
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+int CSIPisConsActive(CSIP_MODEL *model, int idx)
+{
+    assert(idx >= 0 && idx < model->nconss);
+
+    return model->consactive[idx];
+}
+
+static
+CSIP_CONSGROUP *findConsGroup(CSIP_MODEL *model, const char *name)
+{
+    for (int g = 0; g < model->ngroups; ++g)
+    {
+        if (strcmp(model->groups[g].name, name) == 0)
+        {
+            return &model->groups[g];
+        }
+    }
+
+    return NULL;
+}
+
+CSIP_RETCODE CSIPaddConsGroup(CSIP_MODEL *model, const char *name,
+                              int numindices, int *indices)
+{
+    CSIP_CONSGROUP *group = findConsGroup(model, name);
+
+    for (int i = 0; i < numindices; ++i)
+    {
+        if (indices[i] < 0 || indices[i] >= model->nconss)
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+    }
+
+    if (group == NULL)
+    {
+        // do we need to resize?
+        if (model->ngroups >= model->groupssize)
+        {
+            model->groupssize = MAX(GROWFACTOR * model->groupssize, 1);
+            model->groups = (CSIP_CONSGROUP *) realloc(
+                                model->groups,
+                                model->groupssize * sizeof(CSIP_CONSGROUP));
+            if (model->groups == NULL)
+            {
+                return CSIP_RETCODE_NOMEMORY;
+            }
+        }
+
+        group = &model->groups[model->ngroups];
+        group->name = (char *) malloc(strlen(name) + 1);
+        if (group->name == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+        strcpy(group->name, name);
+        group->nconss = 0;
+        group->consssize = 0;
+        group->conss = NULL;
+        ++(model->ngroups);
+    }
+
+    if (group->nconss + numindices > group->consssize)
+    {
+        group->consssize = MAX(GROWFACTOR * group->consssize,
+                               group->nconss + numindices);
+        group->conss = (int *) realloc(group->conss,
+                                       group->consssize * sizeof(int));
+        if (group->conss == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+    }
+    memcpy(group->conss + group->nconss, indices, numindices * sizeof(int));
+    group->nconss += numindices;
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetConsGroupActive(CSIP_MODEL *model, const char *name,
+                                    int active)
+{
+    CSIP_CONSGROUP *group = findConsGroup(model, name);
+
+    if (group == NULL)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    return CSIPsetConsActive(model, group->nconss, group->conss, active);
+}
+
+// append an empty initial solution, complete or partial
+static
+CSIP_RETCODE createInitialSolution(CSIP_MODEL *model, SCIP_Bool partial,
+                                   SCIP_SOL **sol)
+{
+    // the solution must not refer to the transformed problem with the
+    // fixings of a previous CSIPsolveWithFixings, which CSIPsolve frees
+    if (model->tempfixings)
+    {
+        SCIP_in_CSIP(SCIPfreeTransform(model->scip));
+        model->tempfixings = FALSE;
+    }
+
+    // do we need to resize?
+    if (model->ninitialsols >= model->initialsolssize)
+    {
+        model->initialsolssize = MAX(GROWFACTOR * model->initialsolssize, 1);
+        model->initialsols = (SCIP_SOL **) realloc(
+                                 model->initialsols,
+                                 model->initialsolssize * sizeof(SCIP_SOL *));
+        if (model->initialsols == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+    }
+
+    if (partial)
+    {
+        SCIP_in_CSIP(SCIPcreatePartialSol(model->scip, sol, NULL));
+    }
+    else
+    {
+        SCIP_in_CSIP(SCIPcreateSol(model->scip, sol, NULL));
+    }
+    model->initialsols[model->ninitialsols] = *sol;
+    ++(model->ninitialsols);
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddInitialSolution(CSIP_MODEL *model, double *values)
+{
+    SCIP_SOL *sol;
+
+    // are there missing values?
+    SCIP_Bool initialsolpartial = FALSE;
+    for(int i = 0; i < model->nvars; ++i)
+    {
+        SCIP_Real val = values[i];
+        if(val != val) // check for NaN
+        {
+            initialsolpartial = TRUE;
+            break;
+        }
+    }
+
+    // create new solution object
+    CSIP_CALL(createInitialSolution(model, initialsolpartial, &sol));
+    if(initialsolpartial)
+    {
+        // give only the proper values, skip NaN
+        for(int i = 0; i < model->nvars; ++i)
+        {
+            SCIP_Real val = values[i];
+            if(val == val) // check for NaN
+            {
+                SCIP_in_CSIP(SCIPsetSolVal(model->scip, sol, model->vars[i],
+                                           val));
+            }
+        }
+    }
+    else
+    {
+        // copy the given values
+        SCIP_in_CSIP(SCIPsetSolVals(model->scip, sol, model->nvars,
+                                    model->vars, values));
+    }
+
+    // it will be given to SCIP in the CSIPsolve call
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddInitialSolutionSparse(CSIP_MODEL *model, int numindices,
+                                          int *indices, double *values)
+{
+    SCIP_SOL *sol;
+
+    for (int i = 0; i < numindices; ++i)
+    {
+        if (indices[i] < 0 || indices[i] >= model->nvars)
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+    }
+
+    // values of all other variables are missing
+    CSIP_CALL(createInitialSolution(model, TRUE, &sol));
+    for (int i = 0; i < numindices; ++i)
+    {
+        SCIP_in_CSIP(SCIPsetSolVal(model->scip, sol, model->vars[indices[i]],
+                                   values[i]));
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetInitialSolution(CSIP_MODEL *model, double *values)
+{
+    // was solution already given?
+    CSIP_CALL(freeInitialSolutions(model));
+    CSIP_CALL(CSIPaddInitialSolution(model, values));
+
+    return CSIP_RETCODE_OK;
+}
+
+void *CSIPgetInternalSCIP(CSIP_MODEL *model)
+{
+    return model->scip;
+}
+
+
+/*
+ * Constraint Handler
+ */
+
+/* constraint handler data, of lazy constraint handlers and the model
+ * constraint handler */
+struct SCIP_ConshdlrData
+{
+    CSIP_MODEL *model;
+    CSIP_LAZYCALLBACK callback;
+    void *userdata;
+    SCIP_Bool checkonly;
+    SCIP_Bool feasible;
+    SCIP_SOL *sol;
+
+    // values of the current solution, filled on demand during a callback
+    double *solvals;
+    int solvalssize;
+    SCIP_Bool hassolvals;
+
+    // copies of the model constraint handler own their model
+    SCIP_Bool ownsmodel;
+};
+
+/*
+ * Model constraint handler
+ *
+ * SCIP copies plugins before the problem, so copies of the lazy constraint
+ * handlers and heuristics cannot map the variables themselves. Instead, a model
+ * with callbacks gets a constraint of this handler, which has no effect on the
+ * solving process. Its copy creates a CSIP_MODEL for the target SCIP holding the
+ * copies of the variables at their CSIP indices, and the copied callbacks find
+ * this model with findCopyModel.
+ * The constraint is only added to the transformed problem, which is what SCIP
+ * copies during the solve, so that the original problem, as written by
+ * CSIPwriteProblem, does not contain it.
+ */
+
+#define MODELCONSHDLR_NAME "csip_model"
+
+// create a model for a copy of SCIP, variables are set by the caller
+static
+CSIP_RETCODE createModelCopy(CSIP_MODEL *source, SCIP *scip, CSIP_MODEL **copy)
+{
+    *copy = (CSIP_MODEL *) calloc(1, sizeof(CSIP_MODEL));
+    if (*copy == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    (*copy)->scip = scip;
+    (*copy)->nvars = source->nvars;
+    (*copy)->varssize = MAX(source->nvars, 1);
+    (*copy)->vars = (SCIP_VAR **) malloc((*copy)->varssize * sizeof(SCIP_VAR *));
+    if ((*copy)->vars == NULL)
+    {
+        free(*copy);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    (*copy)->objtype = CSIP_OBJTYPE_LINEAR;
+
+    SCIP_in_CSIP(SCIPcreateClock(scip, &(*copy)->lazyclock));
+    SCIP_in_CSIP(SCIPcreateClock(scip, &(*copy)->heurclock));
+
+    return CSIP_RETCODE_OK;
+}
+
+// the variables belong to the copied SCIP and are not released here
+static
+CSIP_RETCODE freeModelCopy(CSIP_MODEL *copy)
+{
+    SCIP_in_CSIP(SCIPfreeClock(copy->scip, &copy->lazyclock));
+    SCIP_in_CSIP(SCIPfreeClock(copy->scip, &copy->heurclock));
+    free(copy->vars);
+    free(copy);
+
+    return CSIP_RETCODE_OK;
+}
+
+// the model of a copied SCIP, or NULL if its constraints were not copied
+static
+CSIP_MODEL *findCopyModel(SCIP *scip)
+{
+    SCIP_CONSHDLR *conshdlr = SCIPfindConshdlr(scip, MODELCONSHDLR_NAME);
+
+    return conshdlr == NULL ? NULL : SCIPconshdlrGetData(conshdlr)->model;
+}
+
+static
+SCIP_DECL_CONSENFOLP(consEnfolpModel)
+{
+    *result = SCIP_FEASIBLE;
+    return SCIP_OKAY;
+}
+
+static
+SCIP_DECL_CONSENFOPS(consEnfopsModel)
+{
+    *result = SCIP_FEASIBLE;
+    return SCIP_OKAY;
+}
+
+static
+SCIP_DECL_CONSCHECK(consCheckModel)
+{
+    *result = SCIP_FEASIBLE;
+    return SCIP_OKAY;
+}
+
+static
+SCIP_DECL_CONSLOCK(consLockModel)
+{
+    return SCIP_OKAY;
+}
+
+static
+SCIP_DECL_CONSFREE(consFreeModel)
+{
+    SCIP_CONSHDLRDATA *conshdlrdata;
+
+    conshdlrdata = SCIPconshdlrGetData(conshdlr);
+    assert(conshdlrdata != NULL);
+
+    if (conshdlrdata->ownsmodel && conshdlrdata->model != NULL)
+    {
+        CSIP_in_SCIP(freeModelCopy(conshdlrdata->model));
+    }
+
+    SCIPfreeMemory(scip, &conshdlrdata);
+    SCIPconshdlrSetData(conshdlr, NULL);
+
+    return SCIP_OKAY;
+}
+
+static
+CSIP_RETCODE createModelCons(SCIP *scip, const char *name, SCIP_CONS **cons)
+{
+    // enforced and checked, so that it is copied like any other constraint
+    SCIP_in_CSIP(SCIPcreateCons(scip, cons, name,
+                                SCIPfindConshdlr(scip, MODELCONSHDLR_NAME), NULL,
+                                FALSE, FALSE, TRUE, TRUE, FALSE, FALSE, FALSE,
+                                FALSE, FALSE, FALSE));
+
+    return CSIP_RETCODE_OK;
+}
+
+static SCIP_DECL_CONSHDLRCOPY(conshdlrCopyModel);
+static SCIP_DECL_CONSCOPY(consCopyModel);
+
+static
+CSIP_RETCODE includeModelConshdlr(SCIP *scip, CSIP_MODEL *model,
+                                  SCIP_Bool ownsmodel)
+{
+    SCIP_CONSHDLRDATA *conshdlrdata;
+    SCIP_CONSHDLR *conshdlr;
+
+    SCIP_in_CSIP(SCIPallocClearMemory(scip, &conshdlrdata));
+    conshdlrdata->model = model;
+    conshdlrdata->ownsmodel = ownsmodel;
+
+    SCIP_in_CSIP(SCIPincludeConshdlrBasic(
+                     scip, &conshdlr, MODELCONSHDLR_NAME,
+                     "variables of CSIP models for copies of callbacks",
+                     -9999999, -9999999, -1, TRUE, consEnfolpModel,
+                     consEnfopsModel, consCheckModel, consLockModel,
+                     conshdlrdata));
+    SCIP_in_CSIP(SCIPsetConshdlrFree(scip, conshdlr, consFreeModel));
+    SCIP_in_CSIP(SCIPsetConshdlrCopy(scip, conshdlr, conshdlrCopyModel,
+                                     consCopyModel));
+
+    return CSIP_RETCODE_OK;
+}
+
+static
+SCIP_DECL_CONSHDLRCOPY(conshdlrCopyModel)
+{
+    // the model is created when the constraint is copied
+    CSIP_in_SCIP(includeModelConshdlr(scip, NULL, TRUE));
+    *valid = TRUE;
+
+    return SCIP_OKAY;
+}
+
+static
+SCIP_DECL_CONSCOPY(consCopyModel)
+{
+    CSIP_MODEL *source = SCIPconshdlrGetData(sourceconshdlr)->model;
+    SCIP_CONSHDLRDATA *conshdlrdata;
+
+    conshdlrdata = SCIPconshdlrGetData(SCIPfindConshdlr(scip,
+                                       MODELCONSHDLR_NAME));
+    *valid = TRUE;
+
+    if (conshdlrdata->model == NULL)
+    {
+        CSIP_MODEL *copy;
+        SCIP_RETCODE retcode = SCIP_OKAY;
+
+        CSIP_in_SCIP(createModelCopy(source, scip, &copy));
+
+        for (int i = 0; i < source->nvars && *valid; ++i)
+        {
+            SCIP_VAR *var = source->vars[i];
+
+            // the variables of the model are original ones
+            if (!SCIPconsIsOriginal(sourcecons))
+            {
+                retcode = SCIPgetTransformedVar(sourcescip, var, &var);
+                if (retcode != SCIP_OKAY)
+                {
+                    break;
+                }
+            }
+            if (var == NULL)
+            {
+                *valid = FALSE;
+                break;
+            }
+            retcode = SCIPgetVarCopy(sourcescip, scip, var, &copy->vars[i],
+                                     varmap, consmap, global, valid);
+            if (retcode != SCIP_OKAY)
+            {
+                break;
+            }
+        }
+
+        // the callbacks only see a model with all variables copied
+        if (retcode != SCIP_OKAY || !*valid)
+        {
+            CSIP_in_SCIP(freeModelCopy(copy));
+            SCIP_CALL(retcode);
+        }
+        else
+        {
+            conshdlrdata->model = copy;
+        }
+    }
+
+    CSIP_in_SCIP(createModelCons(scip, name != NULL ? name
+                                 : SCIPconsGetName(sourcecons), cons));
+
+    return SCIP_OKAY;
+}
+
+// add the model constraint handler, if not done before
+static
+CSIP_RETCODE addModelConshdlr(CSIP_MODEL *model)
+{
+    if (SCIPfindConshdlr(model->scip, MODELCONSHDLR_NAME) != NULL)
+    {
+        return CSIP_RETCODE_OK;
+    }
+
+    CSIP_CALL(includeModelConshdlr(model->scip, model, FALSE));
+
+    return CSIP_RETCODE_OK;
+}
+
+/* before solving, add the model constraint to the transformed problem, if the
+ * model has the handler; later stages come from a solve that added it
+ */
+static
+CSIP_RETCODE addModelCons(CSIP_MODEL *model)
+{
+    SCIP *scip = model->scip;
+    SCIP_CONS *cons;
+
+    if (SCIPfindConshdlr(scip, MODELCONSHDLR_NAME) == NULL
+            || SCIPgetStage(scip) > SCIP_STAGE_TRANSFORMED)
+    {
+        return CSIP_RETCODE_OK;
+    }
+
+    SCIP_in_CSIP(SCIPtransformProb(scip));
+    CSIP_CALL(createModelCons(scip, MODELCONSHDLR_NAME, &cons));
+    SCIP_in_CSIP(SCIPaddCons(scip, cons));
+    SCIP_in_CSIP(SCIPreleaseCons(scip, &cons));
+
+    return CSIP_RETCODE_OK;
+}
+
+/*
+ * Lazy constraint handler
+ */
+
+/* in a copied SCIP, get the model when first needed; returns whether there is
+ * one, which is not the case if the constraints were not copied
+ */
+static
+SCIP_Bool hasLazyModel(SCIP *scip, SCIP_CONSHDLRDATA *conshdlrdata)
+{
+    if (conshdlrdata->model == NULL)
+    {
+        conshdlrdata->model = findCopyModel(scip);
+    }
+
+    return conshdlrdata->model != NULL;
+}
+
+SCIP_DECL_CONSFREE(consFreeLazy)
+{
+    SCIP_CONSHDLRDATA *conshdlrdata;
+
+    conshdlrdata = SCIPconshdlrGetData(conshdlr);
+    assert(conshdlrdata != NULL);
+
+    free(conshdlrdata->solvals);
+    SCIPfreeMemory(scip, &conshdlrdata);
+
+    SCIPconshdlrSetData(conshdlr, NULL);
+
+    return SCIP_OKAY;
+}
+
+SCIP_DECL_CONSENFOLP(consEnfolpLazy)
+{
+    SCIP_CONSHDLRDATA *conshdlrdata;
+    CSIP_RETCODE retcode;
+    double start;
+
+    *result = SCIP_FEASIBLE;
+
+    conshdlrdata = SCIPconshdlrGetData(conshdlr);
+    if (!hasLazyModel(scip, conshdlrdata))
+    {
+        return SCIP_OKAY;
+    }
+    conshdlrdata->checkonly = FALSE;
+    conshdlrdata->feasible = TRUE;
+    conshdlrdata->hassolvals = FALSE;
+
+    conshdlrdata->model->nlazycalls += 1;
+    SCIP_CALL(SCIPstartClock(scip, conshdlrdata->model->lazyclock));
+    start = startPhase(conshdlrdata->model);
+    retcode = conshdlrdata->callback(conshdlrdata->model, conshdlrdata,
+                                     conshdlrdata->userdata);
+    stopPhase(conshdlrdata->model, CSIP_PHASE_LAZYCALLBACK, start);
+    SCIP_CALL(SCIPstopClock(scip, conshdlrdata->model->lazyclock));
+    CSIP_in_SCIP(retcode);
+
+    if (!conshdlrdata->feasible)
+    {
+        *result = SCIP_CONSADDED;
+    }
+
+    return SCIP_OKAY;
+}
+
+/* enfo pseudo solution just call enfo lp solution */
+SCIP_DECL_CONSENFOPS(consEnfopsLazy)
+{
+    return consEnfolpLazy(scip, conshdlr, conss, nconss, nusefulconss,
+                          solinfeasible, result);
+}
+
+/* check callback */
+SCIP_DECL_CONSCHECK(consCheckLazy)
+{
+    SCIP_CONSHDLRDATA *conshdlrdata;
+    CSIP_RETCODE retcode;
+    double start;
+
+    *result = SCIP_FEASIBLE;
+
+    conshdlrdata = SCIPconshdlrGetData(conshdlr);
+    if (!hasLazyModel(scip, conshdlrdata))
+    {
+        return SCIP_OKAY;
+    }
+    conshdlrdata->checkonly = TRUE;
+    conshdlrdata->feasible = TRUE;
+    conshdlrdata->sol = sol;
+    conshdlrdata->hassolvals = FALSE;
+
+    conshdlrdata->model->nlazycalls += 1;
+    SCIP_CALL(SCIPstartClock(scip, conshdlrdata->model->lazyclock));
+    start = startPhase(conshdlrdata->model);
+    retcode = conshdlrdata->callback(conshdlrdata->model, conshdlrdata,
+                                     conshdlrdata->userdata);
+    stopPhase(conshdlrdata->model, CSIP_PHASE_LAZYCALLBACK, start);
+    SCIP_CALL(SCIPstopClock(scip, conshdlrdata->model->lazyclock));
+    CSIP_in_SCIP(retcode);
+
+    if (!conshdlrdata->feasible)
+    {
+        *result = SCIP_INFEASIBLE;
+    }
+
+    return SCIP_OKAY;
+}
+
+/* locks callback */
+SCIP_DECL_CONSLOCK(consLockLazy)
+{
+    int i;
+    SCIP_VAR *var;
+    SCIP_CONSHDLRDATA *conshdlrdata;
+
+    conshdlrdata = SCIPconshdlrGetData(conshdlr);
+    if (!hasLazyModel(scip, conshdlrdata))
+    {
+        return SCIP_OKAY;
+    }
+
+    assert(scip == conshdlrdata->model->scip);
+
+    for (i = 0; i < conshdlrdata->model->nvars; ++i)
+    {
+        var = conshdlrdata->model->vars[i];
+        SCIP_CALL(SCIPaddVarLocks(scip, var, nlockspos + nlocksneg,
+                                  nlockspos + nlocksneg));
+    }
+
+    return SCIP_OKAY;
+}
+
+static SCIP_DECL_CONSHDLRCOPY(conshdlrCopyLazy);
+
+// model is NULL for copies, see findCopyModel
+static
+CSIP_RETCODE includeLazyConshdlr(SCIP *scip, const char *name,
+                                 CSIP_MODEL *model, CSIP_LAZYCALLBACK callback,
+                                 void *userdata)
+{
+    SCIP_CONSHDLRDATA *conshdlrdata;
+    SCIP_CONSHDLR *conshdlr;
+    int enfopriority;
+    int checkpriority;
+    int eagerfreq;
+    SCIP_Bool needscons = FALSE;
+
+    /* cons_integral has enfo priority 0 and we want to be checked before */
+    enfopriority = 1;
+    /* we want to be checked as rarely as possible.
+     * -5000000 is the smallest proper value in SCIP's conshdlrs. */
+    checkpriority = -5000000 - 1;
+    /* no eager evaluations?! */
+    eagerfreq = -1;
+
+    SCIP_in_CSIP(SCIPallocClearMemory(scip, &conshdlrdata));
+
+    conshdlrdata->model = model;
+    conshdlrdata->callback = callback;
+    conshdlrdata->userdata = userdata;
+
+    SCIP_in_CSIP(SCIPincludeConshdlrBasic(
+                     scip, &conshdlr, name, "lazy constraint callback",
+                     enfopriority, checkpriority, eagerfreq, needscons,
+                     consEnfolpLazy, consEnfopsLazy, consCheckLazy, consLockLazy,
+                     conshdlrdata));
+
+    SCIP_in_CSIP(SCIPsetConshdlrFree(scip, conshdlr, consFreeLazy));
+    SCIP_in_CSIP(SCIPsetConshdlrCopy(scip, conshdlr, conshdlrCopyLazy, NULL));
+
+    return CSIP_RETCODE_OK;
+}
+
+// copy the handler such that SCIP's copies (e.g., in sub-MIPs) stay valid
+static
+SCIP_DECL_CONSHDLRCOPY(conshdlrCopyLazy)
+{
+    SCIP_CONSHDLRDATA *conshdlrdata = SCIPconshdlrGetData(conshdlr);
+
+    CSIP_in_SCIP(includeLazyConshdlr(scip, SCIPconshdlrGetName(conshdlr), NULL,
+                                     conshdlrdata->callback,
+                                     conshdlrdata->userdata));
+    *valid = TRUE;
+
+    return SCIP_OKAY;
+}
+
+/*
+ * callback methods
+ */
+
+CSIP_RETCODE CSIPaddLazyCallback(CSIP_MODEL *model, CSIP_LAZYCALLBACK callback,
+                                 void *userdata)
+{
+    char name[SCIP_MAXSTRLEN];
+
+    CSIP_CALL(addModelConshdlr(model));
+
+    SCIPsnprintf(name, SCIP_MAXSTRLEN, "lazycons_%d", model->nlazycb);
+    CSIP_CALL(includeLazyConshdlr(model->scip, name, model, callback,
+                                  userdata));
+    model->nlazycb += 1;
+
+    return CSIP_RETCODE_OK;
+}
+
+static
+CSIP_RETCODE isSolIntegral(SCIP *scip, SCIP_SOL *sol, SCIP_Bool *integral)
+{
+    // inspired by consCheckIntegral in cons_integral.c
+    SCIP_VAR **vars;
+    SCIP_Real solval;
+    int nbin, nint, nimpl, nallinteger;
+
+    SCIP_in_CSIP(SCIPgetSolVarsData(scip, sol, &vars, NULL,
+                                    &nbin, &nint, &nimpl, NULL));
+
+    *integral = TRUE;
+    nallinteger = nbin + nint + nimpl;
+    for (int v = 0; v < nallinteger; ++v)
+    {
+        solval = SCIPgetSolVal(scip, sol, vars[v]);
+        if (!SCIPisFeasIntegral(scip, solval))
+        {
+            *integral = FALSE;
+            break;
+        }
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+
+CSIP_LAZY_CONTEXT CSIPlazyGetContext(CSIP_LAZYDATA *lazydata)
+{
+    SCIP_Bool check = lazydata->checkonly;
+    SCIP_SOL *sol = check ? lazydata->sol : NULL;
+    SCIP_Bool integral = FALSE;
+    CSIP_CALL(isSolIntegral(lazydata->model->scip, sol, &integral));
+
+    if (integral)
+    {
+        return CSIP_LAZY_INTEGRALSOL;
+    }
+    else if (!check)
+    {
+        return CSIP_LAZY_LPRELAX;
+    }
+    else
+    {
+        return CSIP_LAZY_OTHER;
+    }
+}
+
+// values of all variables in the current solution, fetched once per callback
+static
+CSIP_RETCODE getLazySolVals(CSIP_LAZYDATA *lazydata, const double **solvals)
+{
+    CSIP_MODEL *model = lazydata->model;
+
+    if (!lazydata->hassolvals)
+    {
+        if (lazydata->solvalssize < model->nvars)
+        {
+            int newsize = MAX(model->nvars, INITIALSIZE);
+            double *newvals = (double *) realloc(lazydata->solvals,
+                                                 newsize * sizeof(double));
+            if (newvals == NULL)
+            {
+                return CSIP_RETCODE_NOMEMORY;
+            }
+            lazydata->solvals = newvals;
+            lazydata->solvalssize = newsize;
+        }
+
+        SCIP_in_CSIP(SCIPgetSolVals(model->scip,
+                                    lazydata->checkonly ? lazydata->sol : NULL,
+                                    model->nvars, model->vars,
+                                    lazydata->solvals));
+        lazydata->hassolvals = TRUE;
+    }
+
+    *solvals = lazydata->solvals;
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPlazyGetVarValues(CSIP_LAZYDATA *lazydata, double *output)
+{
+    const double *solvals;
+    double start;
+
+    start = startPhase(lazydata->model);
+    CSIP_CALL(getLazySolVals(lazydata, &solvals));
+    memcpy(output, solvals, lazydata->model->nvars * sizeof(double));
+    stopPhase(lazydata->model, CSIP_PHASE_LAZYGETVARVALUES, start);
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPlazyAddLinCons(CSIP_LAZYDATA *lazydata, int numindices,
+                                int *indices,
+                                double *coefs, double lhs, double rhs, int islocal)
+{
+    SCIP *scip;
+    SCIP_CONS *cons;
+    const double *solvals;
+    double activity;
+    double start;
+
+    scip = lazydata->model->scip;
+
+    /* Is it reasonable to assume that if we solved the problem, then the lazy constraint
+     * is satisfied in the original problem? We get the error:
+     * "method <SCIPcreateCons> cannot be called in the solved stage"
+     * and I am guessing this is because SCIP is checking whether the solution found in the
+     * presolved problem is feasible for the original problem. It could happen it is not feasible
+     * because of numerics mainly, hence the question in the comment
+     */
+    if (SCIPgetStage(scip) == SCIP_STAGE_SOLVED)
+    {
+        assert(lazydata->checkonly);
+        lazydata->feasible = TRUE; /* to be very explicit */
+        return CSIP_RETCODE_OK;
+    }
+
+    if (SCIPgetStage(scip) == SCIP_STAGE_TRANSFORMED)
+    {
+        // we can't even create a cons in this stage, we trust the user's judgement
+        lazydata->feasible = FALSE;
+        return CSIP_RETCODE_OK;
+    }
+
+    /* the violation is a sparse dot product with the solution values, so that
+     * no constraint is created for cuts that are only checked
+     */
+    start = startPhase(lazydata->model);
+    CSIP_CALL(getLazySolVals(lazydata, &solvals));
+    activity = 0.0;
+    for (int i = 0; i < numindices; ++i)
+    {
+        activity += coefs[i] * solvals[indices[i]];
+    }
+    stopPhase(lazydata->model, CSIP_PHASE_LAZYCHECKCONS, start);
+
+    if (SCIPisFeasLT(scip, activity, lhs) || SCIPisFeasGT(scip, activity, rhs))
+    {
+        lazydata->feasible = FALSE;
+    }
+
+    /* can not add constraints here */
+    if (SCIPgetStage(scip) == SCIP_STAGE_INIT
+            || SCIPgetStage(scip) == SCIP_STAGE_TRANSFORMING
+            || SCIPgetStage(scip) == SCIP_STAGE_INITSOLVE)
+    {
+        assert(lazydata->checkonly);
+        return CSIP_RETCODE_OK;
+    }
+
+    start = startPhase(lazydata->model);
+    CSIP_CALL(createLinCons(lazydata->model, "lazycons", numindices, indices,
+                            coefs, lhs, rhs, &cons));
+    SCIP_in_CSIP(SCIPsetConsLocal(scip, cons, islocal == 1));
+    stopPhase(lazydata->model, CSIP_PHASE_LAZYCREATECONS, start);
+
+    /* we do not store cons, because the original problem does not contain them;
+     * and there is an issue when freeTransform is called
+     */
+    start = startPhase(lazydata->model);
+    SCIP_in_CSIP(SCIPaddCons(scip, cons));
+    SCIP_in_CSIP(SCIPreleaseCons(lazydata->model->scip, &cons));
+    stopPhase(lazydata->model, CSIP_PHASE_LAZYADDCONS, start);
+
+    return CSIP_RETCODE_OK;
+}
+
+/* Heuristic Plugin */
+
+struct SCIP_HeurData
+{
+    CSIP_MODEL *model;
+    CSIP_HEURCALLBACK callback;
+    void *userdata;
+    SCIP_HEUR *heur;
+    unsigned int stored_sols;
+};
+
+static
+SCIP_DECL_HEURFREE(heurFreeUser)
+{
+    SCIP_HEURDATA *heurdata;
+
+    heurdata = SCIPheurGetData(heur);
+    assert(heurdata != NULL);
+
+    SCIPfreeMemory(scip, &heurdata);
+    SCIPheurSetData(heur, NULL);
+
+    return SCIP_OKAY;
+}
+
+static
+SCIP_DECL_HEUREXEC(heurExecUser)
+{
+    SCIP_HEURDATA *heurdata = SCIPheurGetData(heur);
+    CSIP_RETCODE retcode;
+    double start;
+    assert(heurdata != NULL);
+
+    // in a copied SCIP, get the model when first needed
+    if (heurdata->model == NULL)
+    {
+        heurdata->model = findCopyModel(scip);
+    }
+    if (heurdata->model == NULL)
+    {
+        *result = SCIP_DIDNOTRUN;
+        return SCIP_OKAY;
+    }
+
+    *result = SCIP_DIDNOTFIND;
+    heurdata->stored_sols = 0;
+
+    heurdata->model->nheurcalls += 1;
+    SCIP_CALL(SCIPstartClock(scip, heurdata->model->heurclock));
+    start = startPhase(heurdata->model);
+    retcode = heurdata->callback(heurdata->model, heurdata,
+                                 heurdata->userdata);
+    stopPhase(heurdata->model, CSIP_PHASE_HEURCALLBACK, start);
+    SCIP_CALL(SCIPstopClock(scip, heurdata->model->heurclock));
+    CSIP_in_SCIP(retcode);
+
+    if (heurdata->stored_sols > 0)
+    {
+        *result = SCIP_FOUNDSOL;
+    }
+
+    return SCIP_OKAY;
+}
+
+// Copy values of solution to output array. Call this function from your
+// heuristic callback. Solution is LP relaxation of current node.
+CSIP_RETCODE CSIPheurGetVarValues(CSIP_HEURDATA *heurdata, double *output)
+{
+    CSIP_MODEL *model = heurdata->model;
+    double start = startPhase(model);
+    SCIP_in_CSIP(SCIPgetSolVals(model->scip, NULL, model->nvars, model->vars,
+                                output));
+    stopPhase(model, CSIP_PHASE_HEURGETVARVALUES, start);
+    return CSIP_RETCODE_OK;
+}
+
+// Supply a solution (as a dense array). Only complete solutions are supported.
+CSIP_RETCODE CSIPheurAddSolution(CSIP_HEURDATA *heurdata, double *values)
+{
+    SCIP_SOL *sol;
+    CSIP_MODEL *model = heurdata->model;
+    SCIP *scip = model->scip;
+    unsigned int stored = 0;
+    double start = startPhase(model);
+
+    SCIP_in_CSIP(SCIPcreateSol(scip, &sol, heurdata->heur));
+    SCIP_in_CSIP(SCIPsetSolVals(scip, sol, model->nvars, model->vars, values));
+    SCIP_in_CSIP(SCIPtrySolFree(scip, &sol, FALSE, FALSE, TRUE, TRUE, TRUE, &stored));
+    stopPhase(model, CSIP_PHASE_HEURADDSOLUTION, start);
+
+    if (stored > 0)
+    {
+        heurdata->stored_sols += 1;
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+static SCIP_DECL_HEURCOPY(heurCopyUser);
+
+// model is NULL for copies, see findCopyModel
+static
+CSIP_RETCODE includeUserHeur(SCIP *scip, const char *name, CSIP_MODEL *model,
+                             CSIP_HEURCALLBACK callback, void *userdata)
+{
+    SCIP_HEURDATA *heurdata;
+    SCIP_HEUR *heur;
+
+    SCIP_in_CSIP(SCIPallocMemory(scip, &heurdata));
+
+    SCIP_in_CSIP(SCIPincludeHeurBasic(
+                     scip, &heur, name, "heuristic callback", 'x',
+                     1, 1, 0, -1, SCIP_HEURTIMING_AFTERNODE, FALSE,
+                     heurExecUser, heurdata));
+    heurdata->model = model;
+    heurdata->callback = callback;
+    heurdata->userdata = userdata;
+    heurdata->heur = heur;
+    heurdata->stored_sols = 0;
+
+    SCIP_in_CSIP(SCIPsetHeurFree(scip, heur, heurFreeUser));
+    SCIP_in_CSIP(SCIPsetHeurCopy(scip, heur, heurCopyUser));
+
+    return CSIP_RETCODE_OK;
+}
+
+static
+SCIP_DECL_HEURCOPY(heurCopyUser)
+{
+    SCIP_HEURDATA *heurdata = SCIPheurGetData(heur);
+
+    CSIP_in_SCIP(includeUserHeur(scip, SCIPheurGetName(heur), NULL,
+                                 heurdata->callback, heurdata->userdata));
+
+    return SCIP_OKAY;
+}
+
+// Add a heuristic callback to the model.
+// You may use userdata to pass any data.
+CSIP_RETCODE CSIPaddHeuristicCallback(
+    CSIP_MODEL *model, CSIP_HEURCALLBACK callback, void *userdata)
+{
+    char name[SCIP_MAXSTRLEN];
+
+    CSIP_CALL(addModelConshdlr(model));
+
+    SCIPsnprintf(name, SCIP_MAXSTRLEN, "heur_%d", model->nheur);
+    CSIP_CALL(includeUserHeur(model->scip, name, model, callback, userdata));
+    model->nheur += 1;
+
+    return CSIP_RETCODE_OK;
+}
+
+/*
+ * Event handlers for incumbent and progress callbacks
+ */
+
+struct SCIP_EventhdlrData
+{
+    CSIP_MODEL *model;
+    SCIP_EVENTTYPE eventtype;
+    void *userdata;
+
+    // incumbent callback: the new best solution while it is called
+    CSIP_INCUMBENTCALLBACK incumbentcb;
+    SCIP_SOL *sol;
+
+    // progress callback: frequencies and state at the last call
+    CSIP_PROGRESSCALLBACK progresscb;
+    int nodefreq;
+    double timefreq;
+    SCIP_Longint lastnnodes;
+    double lasttime;
+};
+
+static
+SCIP_DECL_EVENTFREE(eventFreeUser)
+{
+    SCIP_EVENTHDLRDATA *eventhdlrdata;
+
+    eventhdlrdata = SCIPeventhdlrGetData(eventhdlr);
+    assert(eventhdlrdata != NULL);
+
+    SCIPfreeMemory(scip, &eventhdlrdata);
+    SCIPeventhdlrSetData(eventhdlr, NULL);
+
+    return SCIP_OKAY;
+}
+
+/* we can only catch the events after the problem was transformed */
+static
+SCIP_DECL_EVENTINIT(eventInitUser)
+{
+    SCIP_EVENTHDLRDATA *eventhdlrdata = SCIPeventhdlrGetData(eventhdlr);
+    assert(eventhdlrdata != NULL);
+
+    eventhdlrdata->lastnnodes = 0;
+    eventhdlrdata->lasttime = 0.0;
+
+    SCIP_CALL(SCIPcatchEvent(scip, eventhdlrdata->eventtype, eventhdlr,
+                             NULL, NULL));
+
+    return SCIP_OKAY;
+}
+
+static
+SCIP_DECL_EVENTEXIT(eventExitUser)
+{
+    SCIP_EVENTHDLRDATA *eventhdlrdata = SCIPeventhdlrGetData(eventhdlr);
+    assert(eventhdlrdata != NULL);
+
+    SCIP_CALL(SCIPdropEvent(scip, eventhdlrdata->eventtype, eventhdlr,
+                            NULL, -1));
+
+    return SCIP_OKAY;
+}
+
+static
+SCIP_DECL_EVENTEXEC(eventExecIncumbent)
+{
+    SCIP_EVENTHDLRDATA *eventhdlrdata = SCIPeventhdlrGetData(eventhdlr);
+    assert(eventhdlrdata != NULL);
+    assert(SCIPeventGetType(event) == SCIP_EVENTTYPE_BESTSOLFOUND);
+
+    eventhdlrdata->sol = SCIPeventGetSol(event);
+    assert(eventhdlrdata->sol != NULL);
+
+    CSIP_in_SCIP(eventhdlrdata->incumbentcb(eventhdlrdata->model, eventhdlrdata,
+                                            eventhdlrdata->userdata));
+
+    // the solution is owned by SCIP, don't keep it around
+    eventhdlrdata->sol = NULL;
+
+    return SCIP_OKAY;
+}
+
+static
+SCIP_DECL_EVENTEXEC(eventExecProgress)
+{
+    SCIP_EVENTHDLRDATA *eventhdlrdata = SCIPeventhdlrGetData(eventhdlr);
+    CSIP_PROGRESS progress;
+    SCIP_Longint nnodes;
+    double time;
+
+    assert(eventhdlrdata != NULL);
+
+    nnodes = SCIPgetNNodes(scip);
+    time = SCIPgetSolvingTime(scip);
+
+    // only call back if one of the frequencies is reached
+    if (!(eventhdlrdata->nodefreq > 0
+            && nnodes - eventhdlrdata->lastnnodes >= eventhdlrdata->nodefreq)
+            && !(eventhdlrdata->timefreq > 0.0
+                 && time - eventhdlrdata->lasttime >= eventhdlrdata->timefreq))
+    {
+        return SCIP_OKAY;
+    }
+    eventhdlrdata->lastnnodes = nnodes;
+    eventhdlrdata->lasttime = time;
+
+    progress.primalbound = SCIPgetPrimalbound(scip);
+    progress.dualbound = SCIPgetDualbound(scip);
+    progress.gap = SCIPgetGap(scip);
+    progress.nnodes = nnodes;
+    progress.nopennodes = SCIPgetNNodesLeft(scip);
+    progress.nlpiterations = SCIPgetNLPIterations(scip);
+    progress.solvingtime = time;
+
+    CSIP_in_SCIP(eventhdlrdata->progresscb(eventhdlrdata->model, &progress,
+                                           eventhdlrdata->userdata));
+
+    return SCIP_OKAY;
+}
+
+static
+CSIP_RETCODE includeEventhdlr(
+    CSIP_MODEL *model, const char *prefix, SCIP_EVENTTYPE eventtype,
+    SCIP_DECL_EVENTEXEC((*eventexec)), SCIP_EVENTHDLRDATA *eventhdlrdata)
+{
+    SCIP *scip = model->scip;
+    SCIP_EVENTHDLR *eventhdlr;
+    char name[SCIP_MAXSTRLEN];
+
+    eventhdlrdata->model = model;
+    eventhdlrdata->eventtype = eventtype;
+    eventhdlrdata->lastnnodes = 0;
+    eventhdlrdata->lasttime = 0.0;
+
+    SCIPsnprintf(name, SCIP_MAXSTRLEN, "%s_%d", prefix, model->neventhdlr);
+    SCIP_in_CSIP(SCIPincludeEventhdlrBasic(
+                     scip, &eventhdlr, name, "user callback", eventexec,
+                     eventhdlrdata));
+
+    SCIP_in_CSIP(SCIPsetEventhdlrInit(scip, eventhdlr, eventInitUser));
+    SCIP_in_CSIP(SCIPsetEventhdlrExit(scip, eventhdlr, eventExitUser));
+    SCIP_in_CSIP(SCIPsetEventhdlrFree(scip, eventhdlr, eventFreeUser));
+    model->neventhdlr += 1;
+
+    return CSIP_RETCODE_OK;
+}
+
+double CSIPincumbentGetObjValue(CSIP_INCUMBENTDATA *incumbentdata)
+{
+    assert(incumbentdata->sol != NULL);
+    return SCIPgetSolOrigObj(incumbentdata->model->scip, incumbentdata->sol);
+}
+
+CSIP_RETCODE CSIPincumbentGetVarValues(
+    CSIP_INCUMBENTDATA *incumbentdata, double *output)
+{
+    CSIP_MODEL *model = incumbentdata->model;
+    assert(incumbentdata->sol != NULL);
+
+    SCIP_in_CSIP(SCIPgetSolVals(model->scip, incumbentdata->sol, model->nvars,
+                                model->vars, output));
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPincumbentGetVarValuesSparse(
+    CSIP_INCUMBENTDATA *incumbentdata, int numindices, int *indices,
+    double *output)
+{
+    CSIP_MODEL *model = incumbentdata->model;
+    assert(incumbentdata->sol != NULL);
+
+    for (int i = 0; i < numindices; ++i)
+    {
+        assert(indices[i] >= 0 && indices[i] < model->nvars);
+        output[i] = SCIPgetSolVal(model->scip, incumbentdata->sol,
+                                  model->vars[indices[i]]);
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddIncumbentCallback(
+    CSIP_MODEL *model, CSIP_INCUMBENTCALLBACK callback, void *userdata)
+{
+    SCIP_EVENTHDLRDATA *eventhdlrdata;
+
+    SCIP_in_CSIP(SCIPallocClearMemory(model->scip, &eventhdlrdata));
+    eventhdlrdata->incumbentcb = callback;
+    eventhdlrdata->userdata = userdata;
+    eventhdlrdata->sol = NULL;
+
+    CSIP_CALL(includeEventhdlr(model, "incumbent",
+                               SCIP_EVENTTYPE_BESTSOLFOUND,
+                               eventExecIncumbent, eventhdlrdata));
+
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPaddProgressCallback(
+    CSIP_MODEL *model, int nodefreq, double timefreq,
+    CSIP_PROGRESSCALLBACK callback, void *userdata)
+{
+    SCIP_EVENTHDLRDATA *eventhdlrdata;
+
+    SCIP_in_CSIP(SCIPallocClearMemory(model->scip, &eventhdlrdata));
+    eventhdlrdata->progresscb = callback;
+    eventhdlrdata->userdata = userdata;
+    eventhdlrdata->nodefreq = nodefreq;
+    eventhdlrdata->timefreq = timefreq;
+
+    CSIP_CALL(includeEventhdlr(model, "progress", SCIP_EVENTTYPE_NODESOLVED,
+                               eventExecProgress, eventhdlrdata));
+
+    return CSIP_RETCODE_OK;
+}
+
+/*
+ *  Message handler with a prefix
+ */
+
+
+struct SCIP_MessagehdlrData
+{
+    char* prefix;
+
+    // log callback: messages are passed on instead of written to a file
+    CSIP_MODEL* model;
+    CSIP_LOGCALLBACK logcb;
+    void* userdata;
+
+    // buffered output: messages are collected here before they are written
+    char* buffer;
+    size_t buffersize;
+    size_t bufferlen;
+    FILE* bufferfile;
+};
+
+static void logMessage(
+    SCIP_MESSAGEHDLR* messagehdlr, FILE* file, const char* msg)
+{
+    SCIP_MESSAGEHDLRDATA* messagehdlrdata;
+    messagehdlrdata = SCIPmessagehdlrGetData(messagehdlr);
+
+    fputs(messagehdlrdata->prefix, file);
+    fputs(msg, file);
+    fflush(file);
+    return;
+}
+
+static void flushMessageBuffer(SCIP_MESSAGEHDLRDATA* messagehdlrdata)
+{
+    if (messagehdlrdata->bufferlen > 0)
+    {
+        fwrite(messagehdlrdata->buffer, 1, messagehdlrdata->bufferlen,
+               messagehdlrdata->bufferfile);
+        fflush(messagehdlrdata->bufferfile);
+        messagehdlrdata->bufferlen = 0;
+    }
+}
+
+static void bufferMessage(
+    SCIP_MESSAGEHDLRDATA* messagehdlrdata, FILE* file, const char* msg)
+{
+    size_t len = strlen(msg);
+
+    // the buffer only holds messages for a single file
+    if (file != messagehdlrdata->bufferfile)
+    {
+        flushMessageBuffer(messagehdlrdata);
+        messagehdlrdata->bufferfile = file;
+    }
+
+    if (messagehdlrdata->bufferlen + len > messagehdlrdata->buffersize)
+    {
+        flushMessageBuffer(messagehdlrdata);
+    }
+
+    // too long for the buffer, write through
+    if (len > messagehdlrdata->buffersize)
+    {
+        fputs(msg, file);
+        return;
+    }
+
+    memcpy(messagehdlrdata->buffer + messagehdlrdata->bufferlen, msg, len);
+    messagehdlrdata->bufferlen += len;
+}
+
+// SCIP buffers messages until the end of a line, so we prefix whole lines
+static void logMessageBuffered(
+    SCIP_MESSAGEHDLR* messagehdlr, FILE* file, const char* msg)
+{
+    SCIP_MESSAGEHDLRDATA* messagehdlrdata;
+    messagehdlrdata = SCIPmessagehdlrGetData(messagehdlr);
+
+    if (file == NULL)
+    {
+        file = stdout;
+    }
+
+    bufferMessage(messagehdlrdata, file, messagehdlrdata->prefix);
+    bufferMessage(messagehdlrdata, file, msg);
+    return;
+}
+
+static void logCallbackWarning(
+    SCIP_MESSAGEHDLR* messagehdlr, FILE* file, const char* msg)
+{
+    SCIP_MESSAGEHDLRDATA* messagehdlrdata;
+    messagehdlrdata = SCIPmessagehdlrGetData(messagehdlr);
+
+    messagehdlrdata->logcb(messagehdlrdata->model, CSIP_MSGTYPE_WARNING, msg,
+                           messagehdlrdata->userdata);
+    return;
+}
+
+static void logCallbackDialog(
+    SCIP_MESSAGEHDLR* messagehdlr, FILE* file, const char* msg)
+{
+    SCIP_MESSAGEHDLRDATA* messagehdlrdata;
+    messagehdlrdata = SCIPmessagehdlrGetData(messagehdlr);
+
+    messagehdlrdata->logcb(messagehdlrdata->model, CSIP_MSGTYPE_DIALOG, msg,
+                           messagehdlrdata->userdata);
+    return;
+}
+
+static void logCallbackInfo(
+    SCIP_MESSAGEHDLR* messagehdlr, FILE* file, const char* msg)
+{
+    SCIP_MESSAGEHDLRDATA* messagehdlrdata;
+    messagehdlrdata = SCIPmessagehdlrGetData(messagehdlr);
+
+    messagehdlrdata->logcb(messagehdlrdata->model, CSIP_MSGTYPE_INFO, msg,
+                           messagehdlrdata->userdata);
+    return;
+}
+
+static SCIP_DECL_MESSAGEHDLRFREE(messageHdlrFree)
+{
+    SCIP_MESSAGEHDLRDATA* messagehdlrdata = SCIPmessagehdlrGetData(messagehdlr);
+    flushMessageBuffer(messagehdlrdata);
+    free(messagehdlrdata->buffer);
+    free(messagehdlrdata->prefix);
+    SCIPfreeMemory(NULL, &messagehdlrdata);
+    return SCIP_OKAY;
+}
+
+static
+CSIP_RETCODE setMessagehdlr(
+    CSIP_MODEL *model, const char* prefix, int buffersize)
+{
+    SCIP_MESSAGEHDLR* messagehdlr = NULL;
+    SCIP_MESSAGEHDLRDATA* messagehdlrdata = NULL;
+    SCIP_Bool buffered = (buffersize > 0);
+
+    SCIP_in_CSIP(SCIPallocMemory(NULL, &messagehdlrdata));
+    messagehdlrdata->prefix = strDup(prefix);
+    messagehdlrdata->model = model;
+    messagehdlrdata->logcb = NULL;
+    messagehdlrdata->userdata = NULL;
+    messagehdlrdata->buffer = NULL;
+    messagehdlrdata->buffersize = 0;
+    messagehdlrdata->bufferlen = 0;
+    messagehdlrdata->bufferfile = NULL;
+    if (buffered)
+    {
+        messagehdlrdata->buffer = (char *) malloc(buffersize);
+        if (messagehdlrdata->buffer == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
         }
+        messagehdlrdata->buffersize = buffersize;
     }
-    assert(varpos == nvars);
-    // last expression is root
-    assert(exprs[nops - 1] != NULL);
-    SCIP_in_CSIP(SCIPexprtreeCreate(SCIPblkmem(scip), tree, exprs[nops - 1], nvars,
-                                    0, NULL));
 
-    // assign variables to tree
-    SCIP_in_CSIP(SCIPexprtreeSetVars(*tree, nvars, vars));
+    if (buffered)
+    {
+        SCIP_in_CSIP(SCIPmessagehdlrCreate(&messagehdlr, TRUE, NULL, FALSE,
+                                           logMessageBuffered,
+                                           logMessageBuffered,
+                                           logMessageBuffered,
+                                           messageHdlrFree, messagehdlrdata));
+    }
+    else
+    {
+        SCIP_in_CSIP(SCIPmessagehdlrCreate(&messagehdlr, FALSE, NULL, FALSE,
+                                           logMessage, logMessage, logMessage,
+                                           messageHdlrFree, messagehdlrdata));
+    }
 
-    // free memory
-    free(vars);
-    free(exprs);
+    SCIP_in_CSIP(SCIPsetMessagehdlr(model->scip, messagehdlr));
+    SCIP_in_CSIP(SCIPmessagehdlrRelease(&messagehdlr));
+
+    // SCIP keeps the handler alive, we only remember it for flushing
+    model->msghdlr = SCIPgetMessagehdlr(model->scip);
 
     return CSIP_RETCODE_OK;
 }
 
 static
-char *strDup(const char *s) {
-    size_t size = strlen(s) + 1;
-    char *p = malloc(size);
-    if (p)
+void flushMessages(CSIP_MODEL *model)
+{
+    if (model->msghdlr != NULL)
     {
-        memcpy(p, s, size);
+        flushMessageBuffer(SCIPmessagehdlrGetData(model->msghdlr));
     }
-    return p;
 }
 
-/** When the objective is nonlinear we use the epigraph representation.
- * However, changing the objective sense is not  straightforward in that
- * case. The purpose of this function is to change an epigraph objective
- * to represent the correct objective sense. *Starting* from a correct
- * objective, we only need two modifications to correctly change the sense.
- * 0) change sense (this step is not done here)
- * 1) multiply objective function by -1
- * 2) multiply nonlinear function by -1
- * max{ t : f(x) >= t } --> min{ -t : -f(x) >= t }
- * min{ t : f(x) <= t } --> max{ -t : -f(x) <= t }
+CSIP_RETCODE CSIPsetMessagePrefix(CSIP_MODEL *model, const char* prefix)
+{
+    CSIP_CALL(setMessagehdlr(model, prefix, 0));
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetBufferedMessagePrefix(
+    CSIP_MODEL *model, const char* prefix, int buffersize)
+{
+    if (buffersize <= 0)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    CSIP_CALL(setMessagehdlr(model, prefix, buffersize));
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPsetLogCallback(
+    CSIP_MODEL *model, CSIP_LOGCALLBACK logcb, void *userdata, int verblevel)
+{
+    SCIP_MESSAGEHDLR* messagehdlr = NULL;
+    SCIP_MESSAGEHDLRDATA* messagehdlrdata = NULL;
+
+    // SCIP does not even format the messages above the verbosity level
+    SCIP_in_CSIP(SCIPsetIntParam(model->scip, "display/verblevel", verblevel));
+
+    SCIP_in_CSIP(SCIPallocMemory(NULL, &messagehdlrdata));
+    messagehdlrdata->prefix = NULL;
+    messagehdlrdata->model = model;
+    messagehdlrdata->logcb = logcb;
+    messagehdlrdata->userdata = userdata;
+    messagehdlrdata->buffer = NULL;
+    messagehdlrdata->buffersize = 0;
+    messagehdlrdata->bufferlen = 0;
+    messagehdlrdata->bufferfile = NULL;
+
+    // let SCIP buffer the output, so that we pass on complete lines
+    SCIP_in_CSIP(SCIPmessagehdlrCreate(&messagehdlr, TRUE, NULL, FALSE,
+                                       logCallbackWarning, logCallbackDialog,
+                                       logCallbackInfo, messageHdlrFree,
+                                       messagehdlrdata));
+
+    SCIP_in_CSIP(SCIPsetMessagehdlr(model->scip, messagehdlr));
+    SCIP_in_CSIP(SCIPmessagehdlrRelease(&messagehdlr));
+
+    model->msghdlr = SCIPgetMessagehdlr(model->scip);
+
+    return CSIP_RETCODE_OK;
+}
+
+/*
+ * Timing of the callback phases
  */
-CSIP_RETCODE correctObjectiveFunction(CSIP_MODEL *model)
+
+CSIP_RETCODE CSIPsetCallbackTiming(CSIP_MODEL *model, int enable)
 {
-    SCIP *scip = model->scip;
-    SCIP_CONS *objcons = model->objcons;
-    SCIP_VAR *objvar = model->objvar;
+    model->timing = (enable != 0);
+    for (int i = 0; i < CSIP_NPHASES; ++i)
+    {
+        model->phasecalls[i] = 0;
+        model->phasetime[i] = 0.0;
+    }
 
-    // we only apply this for nonlinear objectives
-    if (objvar == NULL)
+    return CSIP_RETCODE_OK;
+}
+
+CSIP_RETCODE CSIPgetCallbackTiming(
+    CSIP_MODEL *model, CSIP_PHASE phase, long long *ncalls, double *totaltime)
+{
+    if (phase < 0 || phase >= CSIP_NPHASES)
     {
-        return CSIP_RETCODE_OK;
+        return CSIP_RETCODE_ERROR;
     }
 
-    assert(objcons != NULL);
+    *ncalls = model->phasecalls[phase];
+    *totaltime = model->phasetime[phase];
 
-    // 1)
-    SCIP_in_CSIP(SCIPchgVarObj(scip, objvar, -1.0 * SCIPvarGetObj(objvar)));
+    return CSIP_RETCODE_OK;
+}
 
-    // 2)
-    // we need to copy the tree, because SCIPsetExprtreesNonlinear
-    // is going to delete it
-    SCIP_EXPRTREE *exprtree;
-    SCIP_in_CSIP(SCIPexprtreeCopy(SCIPblkmem(scip), &exprtree,
-                                  SCIPgetExprtreesNonlinear(scip, objcons)[0]));
-    SCIP_Real exprtreecoef = -SCIPgetExprtreeCoefsNonlinear(scip, objcons)[0];
+CSIP_RETCODE CSIPwriteCallbackTiming(CSIP_MODEL *model, const char *filename)
+{
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
 
-    SCIP_in_CSIP(SCIPsetExprtreesNonlinear(scip, objcons, 1, &exprtree,
-                                           &exprtreecoef));
+    fputs("{\n", file);
+    for (int i = 0; i < CSIP_NPHASES; ++i)
+    {
+        fprintf(file, "  \"%s\": {\"calls\": %lld, \"time\": %.9g}%s\n",
+                phasenames[i], (long long) model->phasecalls[i],
+                model->phasetime[i], i < CSIP_NPHASES - 1 ? "," : "");
+    }
+    fputs("}\n", file);
+
+    if (fclose(file) != 0)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
 
     return CSIP_RETCODE_OK;
 }
 
 /*
- * interface methods
+ * Binary model files
+ *
+ * All numbers are stored in native byte order. After a header with the
+ * problem dimensions come the variables (as arrays of bounds, objective
+ * coefficients and types), the nonlinear objective (if any) and the type of
+ * each constraint. Then follows one block per constraint type, holding the
+ * constraints of that type in CSIP index order. Rows of linear, quadratic, SOS
+ * and indicator constraints are stored in sparse row format, so every array of
+ * a block is read in one go. The file ends with the inactive constraints.
+ *
+ * Sizes read from a file are checked against the bytes left in it before any
+ * memory is allocated for them, and all indices are checked before the
+ * constraints are added to the model.
  */
-int CSIPmajorVersion()
+
+#define CSIP_FILE_MAGIC "CSIPMOD"
+// version 2 added the inactive constraints, version 3 the blocks per type
+#define CSIP_FILE_VERSION 3
+
+/* constraint types in model files, in the order of their blocks */
+#define CSIP_CONSTYPE_LINEAR 0
+#define CSIP_CONSTYPE_QUADRATIC 1
+#define CSIP_CONSTYPE_NONLINEAR 2
+#define CSIP_CONSTYPE_SOS1 3
+#define CSIP_CONSTYPE_SOS2 4
+#define CSIP_CONSTYPE_INDICATOR 5
+#define CSIP_CONSTYPE_SEMICONTINUOUS 6
+#define CSIP_NCONSTYPES 7
+
+/* destination of the model data: a file, or, without a file, a hash of the
+ * data which serves as a fingerprint of the model
+ */
+typedef struct
 {
-    return CSIP_MAJOR_VERSION;
+    FILE *file;
+    unsigned long long hash;
+} CSIP_WRITER;
+
+/* source of the model data; the constraints of each block are created at
+ * their index in conss and only added to the model once the file is read
+ */
+typedef struct
+{
+    FILE *file;
+    long remaining; // bytes not read yet
+    int *constypes;
+    SCIP_CONS **conss;
+} CSIP_READER;
+
+/* rows in sparse row format: row k consists of the entries begin[k] to
+ * begin[k + 1] - 1 of indices and coefs
+ */
+typedef struct
+{
+    int *begin;
+    int *indices;
+    double *coefs;
+} CSIP_ROWS;
+
+static
+SCIP_Bool writeBytes(CSIP_WRITER *writer, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *) data;
+
+    if (writer->file != NULL)
+    {
+        return size == 0 || fwrite(data, 1, size, writer->file) == size;
+    }
+
+    // 64 bit FNV-1a
+    for (size_t i = 0; i < size; ++i)
+    {
+        writer->hash = (writer->hash ^ bytes[i]) * 1099511628211ull;
+    }
+
+    return TRUE;
 }
 
-int CSIPminorVersion()
+static
+SCIP_Bool writeInts(CSIP_WRITER *writer, const int *values, int n)
 {
-    return CSIP_MINOR_VERSION;
+    return writeBytes(writer, values, n * sizeof(int));
 }
 
-int CSIPpatchVersion()
+static
+SCIP_Bool writeReals(CSIP_WRITER *writer, const double *values, int n)
 {
-    return CSIP_PATCH_VERSION;
+    return writeBytes(writer, values, n * sizeof(double));
 }
 
-int CSIPgetVersion()
+// whether n items of the given size are left in the file
+static
+SCIP_Bool canRead(CSIP_READER *reader, int n, size_t size)
 {
-    return (100 * CSIPmajorVersion()
-            + 10 * CSIPminorVersion()
-            + 1 * CSIPpatchVersion());
+    return n >= 0 && (size_t) n <= (size_t) reader->remaining / size;
 }
 
-CSIP_RETCODE CSIPcreateModel(CSIP_MODEL **modelptr)
+static
+SCIP_Bool readBytes(CSIP_READER *reader, void *data, int n, size_t size)
 {
-    CSIP_MODEL *model;
+    if (!canRead(reader, n, size)
+            || (n > 0 && fread(data, size, n, reader->file) != (size_t) n))
+    {
+        return FALSE;
+    }
+    reader->remaining -= (long) (n * size);
 
-    *modelptr = (CSIP_MODEL *)malloc(sizeof(CSIP_MODEL));
-    if (*modelptr == NULL)
+    return TRUE;
+}
+
+static
+SCIP_Bool readInts(CSIP_READER *reader, int *values, int n)
+{
+    return readBytes(reader, values, n, sizeof(int));
+}
+
+static
+SCIP_Bool readReals(CSIP_READER *reader, double *values, int n)
+{
+    return readBytes(reader, values, n, sizeof(double));
+}
+
+/* allocate an array for n values and read them; the caller frees the array,
+ * also on errors
+ */
+static
+CSIP_RETCODE readIntArray(CSIP_READER *reader, int n, int **values)
+{
+    *values = NULL;
+    if (!canRead(reader, n, sizeof(int)))
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    *values = (int *) malloc(MAX(n, 1) * sizeof(int));
+    if (*values == NULL)
     {
         return CSIP_RETCODE_NOMEMORY;
     }
 
-    model = *modelptr;
+    return readInts(reader, *values, n) ? CSIP_RETCODE_OK : CSIP_RETCODE_ERROR;
+}
 
-    SCIP_in_CSIP(SCIPcreate(&model->scip));
-    SCIP_in_CSIP(SCIPincludeDefaultPlugins(model->scip));
-    SCIP_in_CSIP(SCIPcreateProbBasic(model->scip, "name"));
+static
+CSIP_RETCODE readRealArray(CSIP_READER *reader, int n, double **values)
+{
+    *values = NULL;
+    if (!canRead(reader, n, sizeof(double)))
+    {
+        return CSIP_RETCODE_ERROR;
+    }
 
-    model->nvars = 0;
-    model->varssize = INITIALSIZE;
-    model->vars = (SCIP_VAR **) malloc(INITIALSIZE * sizeof(SCIP_VAR *));
-    if (model->vars == NULL)
+    *values = (double *) malloc(MAX(n, 1) * sizeof(double));
+    if (*values == NULL)
     {
         return CSIP_RETCODE_NOMEMORY;
     }
 
-    model->nconss = 0;
-    model->consssize = INITIALSIZE;
-    model->conss = (SCIP_CONS **) malloc(INITIALSIZE * sizeof(SCIP_CONS *));
-    if (model->conss == NULL)
+    return readReals(reader, *values, n) ? CSIP_RETCODE_OK
+           : CSIP_RETCODE_ERROR;
+}
+
+// whether all n indices refer to one of nvars variables
+static
+SCIP_Bool areVarIndices(const int *indices, int n, int nvars)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        if (indices[i] < 0 || indices[i] >= nvars)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static
+void freeRows(CSIP_ROWS *rows)
+{
+    free(rows->begin);
+    free(rows->indices);
+    free(rows->coefs);
+}
+
+static
+CSIP_RETCODE createRows(CSIP_ROWS *rows, int nrows, int nnz)
+{
+    rows->begin = (int *) malloc((nrows + 1) * sizeof(int));
+    rows->indices = (int *) malloc(MAX(nnz, 1) * sizeof(int));
+    rows->coefs = (double *) malloc(MAX(nnz, 1) * sizeof(double));
+    if (rows->begin == NULL || rows->indices == NULL || rows->coefs == NULL)
     {
+        freeRows(rows);
         return CSIP_RETCODE_NOMEMORY;
     }
+    rows->begin[0] = 0;
 
-    model->nlazycb = 0;
-    model->nheur = 0;
-    model->initialsol = NULL;
-    model->objvar = NULL;
-    model->objcons = NULL;
-    model->objtype = CSIP_OBJTYPE_LINEAR;
-    model->msghdlr = NULL;
+    return CSIP_RETCODE_OK;
+}
+
+static
+SCIP_Bool writeRows(CSIP_WRITER *writer, int nrows, const CSIP_ROWS *rows)
+{
+    int nnz = rows->begin[nrows];
+
+    return writeInts(writer, &nnz, 1)
+           && writeInts(writer, rows->begin, nrows + 1)
+           && writeInts(writer, rows->indices, nnz)
+           && writeReals(writer, rows->coefs, nnz);
+}
+
+/* read nrows rows and check that they are well formed and that their indices
+ * refer to variables; the caller frees the rows, also on errors
+ */
+static
+CSIP_RETCODE readRows(CSIP_READER *reader, int nrows, int nvars,
+                      CSIP_ROWS *rows)
+{
+    int nnz;
+    CSIP_RETCODE retcode;
+
+    rows->begin = NULL;
+    rows->indices = NULL;
+    rows->coefs = NULL;
+    if (!readInts(reader, &nnz, 1))
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    retcode = readIntArray(reader, nrows + 1, &rows->begin);
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readIntArray(reader, nnz, &rows->indices);
+    }
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readRealArray(reader, nnz, &rows->coefs);
+    }
+    if (retcode != CSIP_RETCODE_OK)
+    {
+        return retcode;
+    }
+
+    if (rows->begin[0] != 0 || rows->begin[nrows] != nnz
+            || !areVarIndices(rows->indices, nnz, nvars))
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+    for (int k = 0; k < nrows; ++k)
+    {
+        if (rows->begin[k + 1] < rows->begin[k])
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+    }
+
+    return CSIP_RETCODE_OK;
+}
+
+// translate variables to CSIP indices
+static
+void getVarIndices(const int *varindex, int nvars, SCIP_VAR **vars,
+                   int *indices)
+{
+    for (int i = 0; i < nvars; ++i)
+    {
+        indices[i] = varindex[SCIPvarGetProbindex(vars[i])];
+    }
+}
+
+// the variables of n CSIP indices, in a new array; NULL without memory
+static
+SCIP_VAR **getVars(CSIP_MODEL *model, int n, const int *indices)
+{
+    SCIP_VAR **vars = (SCIP_VAR **) malloc(MAX(n, 1) * sizeof(SCIP_VAR *));
 
-    return CSIP_RETCODE_OK;
+    for (int i = 0; vars != NULL && i < n; ++i)
+    {
+        vars[i] = model->vars[indices[i]];
+    }
+
+    return vars;
 }
 
-CSIP_RETCODE CSIPfreeModel(CSIP_MODEL *model)
+// the type of a constraint in model files, or -1 if CSIP does not create it
+static
+int getConsType(SCIP_CONS *cons)
 {
-    int i;
+    const char *hdlrname = SCIPconshdlrGetName(SCIPconsGetHdlr(cons));
 
-    if (model->initialsol != NULL) // solve was not called?
+    if (strcmp(hdlrname, "linear") == 0)
     {
-        SCIP_in_CSIP(SCIPfreeSol(model->scip, &model->initialsol));
+        return CSIP_CONSTYPE_LINEAR;
     }
-
-    /* SCIPreleaseVar sets the given pointer to NULL. However, this pointer is
-     * needed when SCIPfree is called, because it will call the lock method again
-     * which works on the vars stored at model, so we give another pointer
-     * TODO: maybe this is still wrong and one should free the transformed problem
-     * first and then release the vars... we have to check for BMS memory leaks
-     */
-    for (i = 0; i < model->nvars; ++i)
+    if (strcmp(hdlrname, "quadratic") == 0)
     {
-        SCIP_VAR *var;
-        var = model->vars[i];
-        SCIP_in_CSIP(SCIPreleaseVar(model->scip, &var));
+        return CSIP_CONSTYPE_QUADRATIC;
     }
-    for (i = 0; i < model->nconss; ++i)
+    if (strcmp(hdlrname, "nonlinear") == 0)
     {
-        SCIP_in_CSIP(SCIPreleaseCons(model->scip, &model->conss[i]));
+        return CSIP_CONSTYPE_NONLINEAR;
     }
-    if (model->objvar != NULL)
+    if (strcmp(hdlrname, "SOS1") == 0)
     {
-        assert(model->objcons != NULL);
-        SCIP_in_CSIP(SCIPreleaseVar(model->scip, &model->objvar));
-        SCIP_in_CSIP(SCIPreleaseCons(model->scip, &model->objcons));
+        return CSIP_CONSTYPE_SOS1;
+    }
+    if (strcmp(hdlrname, "SOS2") == 0)
+    {
+        return CSIP_CONSTYPE_SOS2;
+    }
+    if (strcmp(hdlrname, "indicator") == 0)
+    {
+        return CSIP_CONSTYPE_INDICATOR;
+    }
+    // CSIP creates bound disjunctions only for semicontinuous variables
+    if (strcmp(hdlrname, "bounddisjunction") == 0)
+    {
+        return CSIP_CONSTYPE_SEMICONTINUOUS;
     }
-    SCIP_in_CSIP(SCIPfree(&model->scip));
-
-    free(model->conss);
-    free(model->vars);
-    free(model);
 
-    return CSIP_RETCODE_OK;
+    return -1;
 }
 
-CSIP_RETCODE CSIPaddVar(CSIP_MODEL *model, double lowerbound, double upperbound,
-                        int vartype, int *idx)
+/* the row of a linear, SOS or indicator constraint, with the weights as
+ * coefficients of SOS constraints and without the slack variable of
+ * indicator constraints; returns the length of the row, which is all that is
+ * computed without indices
+ */
+static
+int getConsRow(SCIP *scip, SCIP_CONS *cons, int constype, const int *varindex,
+               int *indices, double *coefs)
 {
-    SCIP *scip;
-    SCIP_VAR *var;
-
-    scip = model->scip;
-    SCIP_in_CSIP(SCIPfreeTransform(scip));
+    SCIP_VAR **vars;
+    double *vals;
+    int nvars;
+    SCIP_VAR *slackvar = NULL;
+    int n = 0;
 
-    SCIP_in_CSIP(SCIPcreateVarBasic(scip, &var, NULL, lowerbound, upperbound, 0.0,
-                                    vartype));
-    SCIP_in_CSIP(SCIPaddVar(scip, var));
+    switch (constype)
+    {
+    case CSIP_CONSTYPE_LINEAR:
+        vars = SCIPgetVarsLinear(scip, cons);
+        vals = SCIPgetValsLinear(scip, cons);
+        nvars = SCIPgetNVarsLinear(scip, cons);
+        break;
+    case CSIP_CONSTYPE_SOS1:
+        vars = SCIPgetVarsSOS1(scip, cons);
+        vals = SCIPgetWeightsSOS1(scip, cons);
+        nvars = SCIPgetNVarsSOS1(scip, cons);
+        break;
+    case CSIP_CONSTYPE_SOS2:
+        vars = SCIPgetVarsSOS2(scip, cons);
+        vals = SCIPgetWeightsSOS2(scip, cons);
+        nvars = SCIPgetNVarsSOS2(scip, cons);
+        break;
+    default:
+        // the linear constraint holds the row and the slack variable
+        assert(constype == CSIP_CONSTYPE_INDICATOR);
+        vars = SCIPgetVarsLinear(scip, SCIPgetLinearConsIndicator(cons));
+        vals = SCIPgetValsLinear(scip, SCIPgetLinearConsIndicator(cons));
+        nvars = SCIPgetNVarsLinear(scip, SCIPgetLinearConsIndicator(cons));
+        slackvar = SCIPgetSlackVarIndicator(cons);
+    }
 
-    // do we need to resize?
-    if (model->nvars >= model->varssize)
+    for (int i = 0; i < nvars; ++i)
     {
-        model->varssize = GROWFACTOR * model->varssize;
-        model->vars = (SCIP_VAR **) realloc(
-                          model->vars,  model->varssize * sizeof(SCIP_VAR *));
-        if (model->vars == NULL)
+        if (vars[i] != slackvar)
         {
-            return CSIP_RETCODE_NOMEMORY;
+            if (indices != NULL)
+            {
+                indices[n] = varindex[SCIPvarGetProbindex(vars[i])];
+                coefs[n] = vals[i];
+            }
+            ++n;
         }
     }
 
-    if (idx != NULL)
-    {
-        *idx = model->nvars;
-        model->vars[*idx] = var;
-    }
-    else
-    {
-        model->vars[model->nvars] = var;
-    }
-    ++(model->nvars);
+    return n;
+}
 
-    return CSIP_RETCODE_OK;
+static
+CSIP_RETCODE writeTape(CSIP_WRITER *file, SCIP_EXPRTREE *tree,
+                       const int *varindex)
+{
+    CSIP_TAPE tape;
+    int root;
+    SCIP_Bool ok;
+
+    CSIP_CALL(createTape(&tape));
+    CSIP_CALL(exprToTape(SCIPexprtreeGetRoot(tree), SCIPexprtreeGetVars(tree),
+                         varindex, &tape, &root));
+    assert(root == tape.nops - 1);
+
+    ok = writeInts(file, &tape.nops, 1)
+         && writeInts(file, &tape.nchildren, 1)
+         && writeInts(file, &tape.nvalues, 1)
+         && writeInts(file, tape.ops, tape.nops)
+         && writeInts(file, tape.begin, tape.nops + 1)
+         && writeInts(file, tape.children, tape.nchildren)
+         && writeReals(file, tape.values, tape.nvalues);
+    freeTape(&tape);
+
+    return ok ? CSIP_RETCODE_OK : CSIP_RETCODE_ERROR;
 }
 
-CSIP_RETCODE CSIPchgVarLB(CSIP_MODEL *model, int numindices, int *indices,
-                          double *lowerbounds)
+/* read an expression and check it against nvars variables; on errors, the
+ * tape is freed
+ */
+static
+CSIP_RETCODE readTape(CSIP_READER *reader, int nvars, CSIP_TAPE *tape)
 {
-    int i;
-    SCIP *scip;
-    SCIP_VAR *var;
+    int sizes[3];
+    CSIP_RETCODE retcode;
+
+    tape->ops = NULL;
+    tape->begin = NULL;
+    tape->children = NULL;
+    tape->values = NULL;
+    if (!readInts(reader, sizes, 3) || sizes[0] < 1)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+    tape->nops = sizes[0];
+    tape->nchildren = sizes[1];
+    tape->nvalues = sizes[2];
 
-    scip = model->scip;
-    SCIP_in_CSIP(SCIPfreeTransform(scip));
+    retcode = readIntArray(reader, tape->nops, &tape->ops);
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readIntArray(reader, tape->nops + 1, &tape->begin);
+    }
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readIntArray(reader, tape->nchildren, &tape->children);
+    }
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readRealArray(reader, tape->nvalues, &tape->values);
+    }
 
-    for (i = 0; i < numindices; ++i)
+    // the children of each operator lie within the children array
+    for (int i = 0; retcode == CSIP_RETCODE_OK && i < tape->nops; ++i)
     {
-        var = model->vars[indices[i]];
-        SCIP_in_CSIP(SCIPchgVarLb(scip, var, lowerbounds[i]));
+        if (tape->begin[i] < 0 || tape->begin[i] > tape->begin[i + 1])
+        {
+            retcode = CSIP_RETCODE_ERROR;
+        }
+    }
+    if (retcode == CSIP_RETCODE_OK
+            && (tape->begin[tape->nops] != tape->nchildren
+                || !isValidExpr(nvars, tape->nops, tape->ops, tape->children,
+                                tape->begin, tape->values, tape->nvalues)))
+    {
+        retcode = CSIP_RETCODE_ERROR;
     }
 
-    return CSIP_RETCODE_OK;
+    if (retcode != CSIP_RETCODE_OK)
+    {
+        freeTape(tape);
+    }
+
+    return retcode;
 }
 
-CSIP_RETCODE CSIPchgVarUB(CSIP_MODEL *model, int numindices, int *indices,
-                          double *upperbounds)
+// the index of the first constraint of the given type from index i on
+static
+int nextCons(const CSIP_READER *reader, int constype, int i)
 {
-    int i;
-    SCIP *scip;
-    SCIP_VAR *var;
-
-    scip = model->scip;
-    SCIP_in_CSIP(SCIPfreeTransform(scip));
-
-    for (i = 0; i < numindices; ++i)
+    while (reader->constypes[i] != constype)
     {
-        var = model->vars[indices[i]];
-        SCIP_in_CSIP(SCIPchgVarUb(scip, var, upperbounds[i]));
+        ++i;
     }
 
-    return CSIP_RETCODE_OK;
+    return i;
 }
 
-CSIP_RETCODE CSIPchgVarType(
-    CSIP_MODEL *model, int varindex, CSIP_VARTYPE vartype)
+/* write the nrows linear, SOS or indicator constraints of the given type:
+ * their rows, followed by the sides of linear constraints or by the binary
+ * variables, active values and right hand sides of indicator constraints
+ */
+static
+CSIP_RETCODE writeRowBlock(CSIP_WRITER *writer, CSIP_MODEL *model,
+                           const int *constypes, int constype, int nrows,
+                           const int *varindex)
 {
     SCIP *scip = model->scip;
-    SCIP_VAR *var = model->vars[varindex];
-    SCIP_Bool infeas = FALSE;
-
-    SCIP_in_CSIP(SCIPfreeTransform(scip));
-
-    SCIP_in_CSIP(SCIPchgVarType(scip, var, vartype, &infeas));
-    // TODO: don't ignore `infeas`?
-    // for SCIP, solving a problem with a binary variable with bounds not in [0,1] produces an error
-    // here we change them to the correct value, since JuMP seems to expect that behaviour
-    // see JuMP tests: [probmod] Test bound modification on binaries
-    if (vartype == CSIP_VARTYPE_BINARY && SCIPvarGetLbLocal(var) < 0.0)
+    CSIP_ROWS rows;
+    double *lhss;
+    double *rhss;
+    int *binindices;
+    int *activevals;
+    int nnz = 0;
+    int k = 0;
+    SCIP_Bool ok;
+
+    for (int i = 0; i < model->nconss; ++i)
     {
-        SCIP_in_CSIP(SCIPchgVarLb(scip, var, 0.0));
+        if (constypes[i] == constype)
+        {
+            nnz += getConsRow(scip, model->conss[i], constype, varindex, NULL,
+                              NULL);
+        }
     }
-    if (vartype == CSIP_VARTYPE_BINARY && SCIPvarGetUbLocal(var) > 1.0)
+
+    if (createRows(&rows, nrows, nnz) != CSIP_RETCODE_OK)
     {
-        SCIP_in_CSIP(SCIPchgVarUb(scip, var, 1.0));
+        return CSIP_RETCODE_NOMEMORY;
     }
+    lhss = (double *) malloc(MAX(nrows, 1) * sizeof(double));
+    rhss = (double *) malloc(MAX(nrows, 1) * sizeof(double));
+    binindices = (int *) malloc(MAX(nrows, 1) * sizeof(int));
+    activevals = (int *) malloc(MAX(nrows, 1) * sizeof(int));
+    ok = (lhss != NULL && rhss != NULL && binindices != NULL
+          && activevals != NULL);
+
+    for (int i = 0; ok && i < model->nconss; ++i)
+    {
+        SCIP_CONS *cons = model->conss[i];
+        int begin = rows.begin[k];
 
-    return CSIP_RETCODE_OK;
-}
+        if (constypes[i] != constype)
+        {
+            continue;
+        }
 
-CSIP_VARTYPE CSIPgetVarType(CSIP_MODEL *model, int varindex)
-{
-    assert(varindex >= 0 && varindex < model->nvars);
+        rows.begin[k + 1] = begin + getConsRow(scip, cons, constype, varindex,
+                                               &rows.indices[begin],
+                                               &rows.coefs[begin]);
+        if (constype == CSIP_CONSTYPE_LINEAR)
+        {
+            lhss[k] = SCIPgetLhsLinear(scip, cons);
+            rhss[k] = SCIPgetRhsLinear(scip, cons);
+        }
+        else if (constype == CSIP_CONSTYPE_INDICATOR)
+        {
+            // a negated binary variable stands for activation on 0
+            SCIP_VAR *binvar = SCIPgetBinaryVarIndicator(cons);
 
-    switch (SCIPvarGetType(model->vars[varindex]))
-    {
-    case SCIP_VARTYPE_BINARY:
-        return CSIP_VARTYPE_BINARY;
-    case SCIP_VARTYPE_INTEGER:
-        return CSIP_VARTYPE_INTEGER;
-    case SCIP_VARTYPE_IMPLINT:
-        return CSIP_VARTYPE_IMPLINT;
-    case SCIP_VARTYPE_CONTINUOUS:
-        return CSIP_VARTYPE_CONTINUOUS;
+            activevals[k] = !SCIPvarIsNegated(binvar);
+            if (!activevals[k])
+            {
+                binvar = SCIPvarGetNegatedVar(binvar);
+            }
+            binindices[k] = varindex[SCIPvarGetProbindex(binvar)];
+            rhss[k] = SCIPgetRhsLinear(scip, SCIPgetLinearConsIndicator(cons));
+        }
+        ++k;
     }
-    return -1;
-}
 
-CSIP_RETCODE CSIPaddLinCons(CSIP_MODEL *model, int numindices, int *indices,
-                            double *coefs, double lhs, double rhs, int *idx)
-{
-    SCIP_CONS *cons;
+    if (!ok)
+    {
+        free(lhss);
+        free(rhss);
+        free(binindices);
+        free(activevals);
+        freeRows(&rows);
+        return CSIP_RETCODE_NOMEMORY;
+    }
 
-    SCIP_in_CSIP(SCIPfreeTransform(model->scip));
+    ok = writeRows(writer, nrows, &rows);
+    if (constype == CSIP_CONSTYPE_LINEAR)
+    {
+        ok = ok && writeReals(writer, lhss, nrows)
+             && writeReals(writer, rhss, nrows);
+    }
+    else if (constype == CSIP_CONSTYPE_INDICATOR)
+    {
+        ok = ok && writeInts(writer, binindices, nrows)
+             && writeInts(writer, activevals, nrows)
+             && writeReals(writer, rhss, nrows);
+    }
 
-    CSIP_CALL(createLinCons(model, numindices, indices, coefs, lhs, rhs, &cons));
-    CSIP_CALL(addCons(model, cons, idx));
+    free(lhss);
+    free(rhss);
+    free(binindices);
+    free(activevals);
+    freeRows(&rows);
 
-    return CSIP_RETCODE_OK;
+    return ok ? CSIP_RETCODE_OK : CSIP_RETCODE_ERROR;
 }
 
-CSIP_RETCODE CSIPaddQuadCons(CSIP_MODEL *model, int numlinindices,
-                             int *linindices,
-                             double *lincoefs, int numquadterms,
-                             int *quadrowindices, int *quadcolindices,
-                             double *quadcoefs, double lhs, double rhs, int *idx)
+// create the nrows constraints of a block written by writeRowBlock
+static
+CSIP_RETCODE readRowBlock(CSIP_READER *reader, CSIP_MODEL *model,
+                          int constype, int nrows)
 {
-    int i;
-    SCIP *scip;
-    SCIP_VAR *linvar;
-    SCIP_VAR *var1;
-    SCIP_VAR *var2;
-    SCIP_CONS *cons;
-
-    scip = model->scip;
-    SCIP_in_CSIP(SCIPfreeTransform(scip));
-
-    SCIP_in_CSIP(SCIPcreateConsBasicQuadratic(scip, &cons, "quadcons", 0, NULL,
-                 NULL, 0, NULL, NULL, NULL, lhs, rhs));
-
-    for (i = 0; i < numlinindices; ++i)
+    SCIP *scip = model->scip;
+    CSIP_ROWS rows;
+    double *lhss = NULL;
+    double *rhss = NULL;
+    int *binindices = NULL;
+    int *activevals = NULL;
+    SCIP_VAR **vars = NULL;
+    CSIP_RETCODE retcode;
+
+    retcode = readRows(reader, nrows, model->nvars, &rows);
+    if (retcode == CSIP_RETCODE_OK && constype == CSIP_CONSTYPE_LINEAR)
     {
-        linvar = model->vars[linindices[i]];
-        SCIP_in_CSIP(SCIPaddLinearVarQuadratic(scip, cons, linvar, lincoefs[i]));
+        retcode = readRealArray(reader, nrows, &lhss);
+        if (retcode == CSIP_RETCODE_OK)
+        {
+            retcode = readRealArray(reader, nrows, &rhss);
+        }
+    }
+    else if (retcode == CSIP_RETCODE_OK
+             && constype == CSIP_CONSTYPE_INDICATOR)
+    {
+        retcode = readIntArray(reader, nrows, &binindices);
+        if (retcode == CSIP_RETCODE_OK)
+        {
+            retcode = readIntArray(reader, nrows, &activevals);
+        }
+        if (retcode == CSIP_RETCODE_OK)
+        {
+            retcode = readRealArray(reader, nrows, &rhss);
+        }
+        // the rows are written as <= rows, see CSIPaddIndicator
+        for (int k = 0; retcode == CSIP_RETCODE_OK && k < nrows; ++k)
+        {
+            if (!isValidIndicator(model, binindices[k], activevals[k], 0, NULL,
+                                  -SCIPinfinity(scip), rhss[k]))
+            {
+                retcode = CSIP_RETCODE_ERROR;
+            }
+        }
+    }
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        vars = getVars(model, rows.begin[nrows], rows.indices);
+        if (vars == NULL)
+        {
+            retcode = CSIP_RETCODE_NOMEMORY;
+        }
     }
 
-    for (i = 0; i < numquadterms; ++i)
+    for (int k = 0, i = 0; retcode == CSIP_RETCODE_OK && k < nrows; ++k, ++i)
     {
-        var1 = model->vars[quadrowindices[i]];
-        var2 = model->vars[quadcolindices[i]];
-        SCIP_in_CSIP(SCIPaddBilinTermQuadratic(scip, cons, var1, var2, quadcoefs[i]));
+        SCIP_VAR **rowvars = &vars[rows.begin[k]];
+        double *rowcoefs = &rows.coefs[rows.begin[k]];
+        int n = rows.begin[k + 1] - rows.begin[k];
+        SCIP_VAR *binvar;
+        SCIP_CONS **cons;
+        char name[SCIP_MAXSTRLEN];
+
+        i = nextCons(reader, constype, i);
+        cons = &reader->conss[i];
+        (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "c%d", i);
+        switch (constype)
+        {
+        case CSIP_CONSTYPE_LINEAR:
+            retcode = retCodeSCIPtoCSIP(SCIPcreateConsBasicLinear(scip, cons,
+                                        name, n, rowvars, rowcoefs, lhss[k], rhss[k]));
+            break;
+        case CSIP_CONSTYPE_SOS1:
+            retcode = retCodeSCIPtoCSIP(SCIPcreateConsBasicSOS1(scip, cons,
+                                        name, n, rowvars, rowcoefs));
+            break;
+        case CSIP_CONSTYPE_SOS2:
+            retcode = retCodeSCIPtoCSIP(SCIPcreateConsBasicSOS2(scip, cons,
+                                        name, n, rowvars, rowcoefs));
+            break;
+        default:
+            // cons_indicator activates on 1, so use the negated variable for 0
+            binvar = model->vars[binindices[k]];
+            if (!activevals[k])
+            {
+                retcode = retCodeSCIPtoCSIP(SCIPgetNegatedVar(scip, binvar,
+                                            &binvar));
+            }
+            if (retcode == CSIP_RETCODE_OK)
+            {
+                retcode = retCodeSCIPtoCSIP(SCIPcreateConsBasicIndicator(scip,
+                                            cons, name, binvar, n, rowvars, rowcoefs, rhss[k]));
+            }
+        }
     }
 
-    CSIP_CALL(addCons(model, cons, idx));
+    free(vars);
+    free(lhss);
+    free(rhss);
+    free(binindices);
+    free(activevals);
+    freeRows(&rows);
 
-    return CSIP_RETCODE_OK;
+    return retcode;
 }
 
-// we might be assuming that the indices of the children of op[k]
-// are always <= k (when op[k] is not VARIDX nor CONST)
-// this implies that the root expression is the last one, which is
-// another assumption
-CSIP_RETCODE CSIPaddNonLinCons(
-    CSIP_MODEL *model, int nops, CSIP_OP *ops, int *children, int *begin,
-    double *values, double lhs, double rhs, int *idx)
+/* write the nrows quadratic constraints: the rows of their linear parts, the
+ * rows of their quadratic parts with the variables of the rows as indices,
+ * the variables of the columns and the sides; quadratic variable terms are
+ * split into linear and square terms
+ */
+static
+CSIP_RETCODE writeQuadraticBlock(CSIP_WRITER *writer, CSIP_MODEL *model,
+                                 const int *constypes, int nrows,
+                                 const int *varindex)
 {
-    SCIP *scip;
-    SCIP_EXPRTREE *tree;
-    SCIP_CONS *cons;
+    SCIP *scip = model->scip;
+    CSIP_ROWS linrows;
+    CSIP_ROWS quadrows;
+    int *colindices;
+    double *lhss;
+    double *rhss;
+    int nlin = 0;
+    int nquad = 0;
+    int k = 0;
+    SCIP_Bool ok;
+
+    for (int i = 0; i < model->nconss; ++i)
+    {
+        if (constypes[i] == CSIP_CONSTYPE_QUADRATIC)
+        {
+            int nquadvars = SCIPgetNQuadVarTermsQuadratic(scip,
+                            model->conss[i]);
+
+            nlin += SCIPgetNLinearVarsQuadratic(scip, model->conss[i])
+                    + nquadvars;
+            nquad += nquadvars
+                     + SCIPgetNBilinTermsQuadratic(scip, model->conss[i]);
+        }
+    }
+
+    if (createRows(&linrows, nrows, nlin) != CSIP_RETCODE_OK)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    if (createRows(&quadrows, nrows, nquad) != CSIP_RETCODE_OK)
+    {
+        freeRows(&linrows);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    colindices = (int *) malloc(MAX(nquad, 1) * sizeof(int));
+    lhss = (double *) malloc(MAX(nrows, 1) * sizeof(double));
+    rhss = (double *) malloc(MAX(nrows, 1) * sizeof(double));
+    ok = (colindices != NULL && lhss != NULL && rhss != NULL);
 
-    CSIP_CALL(createExprtree(model, nops, ops, children, begin,
-                             values, &tree));
+    for (int i = 0; ok && i < model->nconss; ++i)
+    {
+        SCIP_CONS *cons = model->conss[i];
+        int nlinvars;
+        int nquadvars;
+        int nbilin;
+        SCIP_QUADVARTERM *quadvarterms;
+        SCIP_BILINTERM *bilinterms;
+        int l = linrows.begin[k];
+        int q = quadrows.begin[k];
+
+        if (constypes[i] != CSIP_CONSTYPE_QUADRATIC)
+        {
+            continue;
+        }
 
-    scip = model->scip;
-    SCIP_in_CSIP(SCIPfreeTransform(scip));
+        nlinvars = SCIPgetNLinearVarsQuadratic(scip, cons);
+        nquadvars = SCIPgetNQuadVarTermsQuadratic(scip, cons);
+        nbilin = SCIPgetNBilinTermsQuadratic(scip, cons);
+        quadvarterms = SCIPgetQuadVarTermsQuadratic(scip, cons);
+        bilinterms = SCIPgetBilinTermsQuadratic(scip, cons);
+
+        getVarIndices(varindex, nlinvars,
+                      SCIPgetLinearVarsQuadratic(scip, cons),
+                      &linrows.indices[l]);
+        memcpy(&linrows.coefs[l], SCIPgetCoefsLinearVarsQuadratic(scip, cons),
+               nlinvars * sizeof(double));
+        l += nlinvars;
+        for (int j = 0; j < nquadvars; ++j)
+        {
+            int idx = varindex[SCIPvarGetProbindex(quadvarterms[j].var)];
+
+            linrows.indices[l] = idx;
+            linrows.coefs[l] = quadvarterms[j].lincoef;
+            ++l;
+            quadrows.indices[q] = idx;
+            colindices[q] = idx;
+            quadrows.coefs[q] = quadvarterms[j].sqrcoef;
+            ++q;
+        }
+        for (int j = 0; j < nbilin; ++j)
+        {
+            quadrows.indices[q] =
+                varindex[SCIPvarGetProbindex(bilinterms[j].var1)];
+            colindices[q] = varindex[SCIPvarGetProbindex(bilinterms[j].var2)];
+            quadrows.coefs[q] = bilinterms[j].coef;
+            ++q;
+        }
 
-    // create nonlinear constraint
-    SCIP_in_CSIP(SCIPcreateConsBasicNonlinear(scip, &cons, "nonlin", 0, NULL, NULL,
-                 1, &tree, NULL, lhs, rhs));
+        linrows.begin[k + 1] = l;
+        quadrows.begin[k + 1] = q;
+        lhss[k] = SCIPgetLhsQuadratic(scip, cons);
+        rhss[k] = SCIPgetRhsQuadratic(scip, cons);
+        ++k;
+    }
 
-    CSIP_CALL(addCons(model, cons, idx));
+    ok = ok && writeRows(writer, nrows, &linrows)
+         && writeRows(writer, nrows, &quadrows)
+         && writeInts(writer, colindices, nquad)
+         && writeReals(writer, lhss, nrows)
+         && writeReals(writer, rhss, nrows);
 
-    // free memory
-    SCIP_in_CSIP(SCIPexprtreeFree(&tree));
+    free(colindices);
+    free(lhss);
+    free(rhss);
+    freeRows(&linrows);
+    freeRows(&quadrows);
 
-    return CSIP_RETCODE_OK;
+    return ok ? CSIP_RETCODE_OK : CSIP_RETCODE_ERROR;
 }
 
-CSIP_RETCODE CSIPaddSOS1(
-    CSIP_MODEL *model, int numindices, int *indices, double *weights, int *idx)
+// create the nrows constraints of a block written by writeQuadraticBlock
+static
+CSIP_RETCODE readQuadraticBlock(CSIP_READER *reader, CSIP_MODEL *model,
+                                int nrows)
 {
     SCIP *scip = model->scip;
-    SCIP_CONS *cons;
-    SCIP_VAR **vars = (SCIP_VAR **) malloc(numindices * sizeof(SCIP_VAR *));
-    double* auxweights = weights;
-
-    SCIP_in_CSIP(SCIPfreeTransform(scip));
-    if (vars == NULL)
+    CSIP_ROWS linrows;
+    CSIP_ROWS quadrows;
+    int *colindices = NULL;
+    double *lhss = NULL;
+    double *rhss = NULL;
+    SCIP_VAR **linvars = NULL;
+    SCIP_VAR **rowvars = NULL;
+    SCIP_VAR **colvars = NULL;
+    CSIP_RETCODE retcode;
+
+    quadrows.begin = NULL;
+    quadrows.indices = NULL;
+    quadrows.coefs = NULL;
+    retcode = readRows(reader, nrows, model->nvars, &linrows);
+    if (retcode == CSIP_RETCODE_OK)
     {
-        return CSIP_RETCODE_NOMEMORY;
+        retcode = readRows(reader, nrows, model->nvars, &quadrows);
     }
-    for (int i = 0; i < numindices; ++i)
+    if (retcode == CSIP_RETCODE_OK)
     {
-        vars[i] = model->vars[indices[i]];
+        retcode = readIntArray(reader, quadrows.begin[nrows], &colindices);
     }
-
-    /* give weights to avoid an assert in SCIP */
-    if (weights == NULL)
+    if (retcode == CSIP_RETCODE_OK)
     {
-       auxweights = (double *) malloc(numindices * sizeof(double));
-       if (auxweights == NULL)
-       {
-          return CSIP_RETCODE_NOMEMORY;
-       }
-       for (int i = 0; i < numindices; ++i)
-       {
-          auxweights[i] = i;
-       }
+        retcode = readRealArray(reader, nrows, &lhss);
+    }
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readRealArray(reader, nrows, &rhss);
+    }
+    if (retcode == CSIP_RETCODE_OK
+            && !areVarIndices(colindices, quadrows.begin[nrows], model->nvars))
+    {
+        retcode = CSIP_RETCODE_ERROR;
+    }
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        linvars = getVars(model, linrows.begin[nrows], linrows.indices);
+        rowvars = getVars(model, quadrows.begin[nrows], quadrows.indices);
+        colvars = getVars(model, quadrows.begin[nrows], colindices);
+        if (linvars == NULL || rowvars == NULL || colvars == NULL)
+        {
+            retcode = CSIP_RETCODE_NOMEMORY;
+        }
     }
 
-    SCIP_in_CSIP(SCIPcreateConsBasicSOS1(
-                     scip, &cons, "sos1", numindices, vars, auxweights));
-    CSIP_CALL(addCons(model, cons, idx));
-
-    if (weights == NULL)
+    // a term with the same variable twice is a square term
+    for (int k = 0, i = 0; retcode == CSIP_RETCODE_OK && k < nrows; ++k, ++i)
     {
-       free(auxweights);
+        int l = linrows.begin[k];
+        int q = quadrows.begin[k];
+        int nlin = linrows.begin[k + 1] - l;
+        int nquad = quadrows.begin[k + 1] - q;
+        char name[SCIP_MAXSTRLEN];
+
+        i = nextCons(reader, CSIP_CONSTYPE_QUADRATIC, i);
+        (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "c%d", i);
+        retcode = retCodeSCIPtoCSIP(SCIPcreateConsBasicQuadratic(scip,
+                                    &reader->conss[i], name, nlin, &linvars[l],
+                                    &linrows.coefs[l], nquad, &rowvars[q], &colvars[q],
+                                    &quadrows.coefs[q], lhss[k], rhss[k]));
     }
-    free(vars);
 
-    return CSIP_RETCODE_OK;
+    free(linvars);
+    free(rowvars);
+    free(colvars);
+    free(colindices);
+    free(lhss);
+    free(rhss);
+    freeRows(&linrows);
+    freeRows(&quadrows);
+
+    return retcode;
 }
 
-CSIP_RETCODE CSIPaddSOS2(
-    CSIP_MODEL *model, int numindices, int *indices, double *weights, int *idx)
+// write the sides of the nrows nonlinear constraints, then their expressions
+static
+CSIP_RETCODE writeNonlinearBlock(CSIP_WRITER *writer, CSIP_MODEL *model,
+                                 const int *constypes, int nrows,
+                                 const int *varindex)
 {
     SCIP *scip = model->scip;
-    SCIP_CONS *cons;
-    SCIP_VAR **vars = (SCIP_VAR **) malloc(numindices * sizeof(SCIP_VAR *));
-    double* auxweights = weights;
-
-    SCIP_in_CSIP(SCIPfreeTransform(scip));
-
-    if (vars == NULL)
+    double *lhss;
+    double *rhss;
+    int k = 0;
+    SCIP_Bool ok;
+    CSIP_RETCODE retcode = CSIP_RETCODE_OK;
+
+    lhss = (double *) malloc(MAX(nrows, 1) * sizeof(double));
+    rhss = (double *) malloc(MAX(nrows, 1) * sizeof(double));
+    if (lhss == NULL || rhss == NULL)
     {
+        free(lhss);
+        free(rhss);
         return CSIP_RETCODE_NOMEMORY;
     }
-    for (int i = 0; i < numindices; ++i)
-    {
-        vars[i] = model->vars[indices[i]];
-    }
 
-    /* give weights to avoid an assert in SCIP */
-    if (weights == NULL)
+    for (int i = 0; retcode == CSIP_RETCODE_OK && i < model->nconss; ++i)
     {
-       auxweights = (double *) malloc(numindices * sizeof(double));
-       if (auxweights == NULL)
-       {
-          return CSIP_RETCODE_NOMEMORY;
-       }
-       for (int i = 0; i < numindices; ++i)
-       {
-          auxweights[i] = i;
-       }
+        SCIP_CONS *cons = model->conss[i];
+
+        if (constypes[i] != CSIP_CONSTYPE_NONLINEAR)
+        {
+            continue;
+        }
+
+        // CSIP creates nonlinear constraints from a single expression
+        if (SCIPgetNExprtreesNonlinear(scip, cons) != 1
+                || SCIPgetNLinearVarsNonlinear(scip, cons) != 0
+                || SCIPgetExprtreeCoefsNonlinear(scip, cons)[0] != 1.0)
+        {
+            retcode = CSIP_RETCODE_ERROR;
+        }
+        lhss[k] = SCIPgetLhsNonlinear(scip, cons);
+        rhss[k] = SCIPgetRhsNonlinear(scip, cons);
+        ++k;
     }
 
-    SCIP_in_CSIP(SCIPcreateConsBasicSOS2(
-                     scip, &cons, "sos2", numindices, vars, auxweights));
-    CSIP_CALL(addCons(model, cons, idx));
+    ok = retcode != CSIP_RETCODE_OK
+         || (writeReals(writer, lhss, nrows)
+             && writeReals(writer, rhss, nrows));
+    free(lhss);
+    free(rhss);
 
-    if (weights == NULL)
+    for (int i = 0; ok && retcode == CSIP_RETCODE_OK && i < model->nconss; ++i)
     {
-       free(auxweights);
+        if (constypes[i] == CSIP_CONSTYPE_NONLINEAR)
+        {
+            retcode = writeTape(writer, SCIPgetExprtreesNonlinear(
+                                    scip, model->conss[i])[0], varindex);
+        }
     }
-    free(vars);
 
-    return CSIP_RETCODE_OK;
+    return ok ? retcode : CSIP_RETCODE_ERROR;
 }
 
-CSIP_RETCODE CSIPsetObj(CSIP_MODEL *model, int numindices, int *indices,
-                        double *coefs)
+// create the nrows constraints of a block written by writeNonlinearBlock
+static
+CSIP_RETCODE readNonlinearBlock(CSIP_READER *reader, CSIP_MODEL *model,
+                                int nrows)
 {
-    int i;
-    SCIP *scip;
-    SCIP_VAR *var;
-
-    scip = model->scip;
-    SCIP_in_CSIP(SCIPfreeTransform(scip));
+    SCIP *scip = model->scip;
+    double *lhss = NULL;
+    double *rhss = NULL;
+    CSIP_RETCODE retcode;
 
-    for (i = 0; i < numindices; ++i)
+    retcode = readRealArray(reader, nrows, &lhss);
+    if (retcode == CSIP_RETCODE_OK)
     {
-        var = model->vars[indices[i]];
-        SCIP_in_CSIP(SCIPchgVarObj(scip, var, coefs[i]));
+        retcode = readRealArray(reader, nrows, &rhss);
     }
-    model->objtype = CSIP_OBJTYPE_LINEAR;
 
-    // if nonlinear objective was set, remove objvar from objective
-    // and relax its bounds. This should render the objective constraint
-    // redundant
-    if (model->objvar != NULL)
+    for (int k = 0, i = 0; retcode == CSIP_RETCODE_OK && k < nrows; ++k, ++i)
     {
-        SCIP_in_CSIP(SCIPchgVarObj(scip, model->objvar, 0.0));
-        SCIP_in_CSIP(SCIPchgVarLb(scip, model->objvar, -SCIPinfinity(scip)));
-        SCIP_in_CSIP(SCIPchgVarUb(scip, model->objvar, SCIPinfinity(scip)));
+        CSIP_TAPE tape;
+        SCIP_EXPRTREE *tree;
+        char name[SCIP_MAXSTRLEN];
+
+        retcode = readTape(reader, model->nvars, &tape);
+        if (retcode != CSIP_RETCODE_OK)
+        {
+            break;
+        }
+        retcode = createExprtree(model, tape.nops, tape.ops, tape.children,
+                                 tape.begin, tape.values, &tree);
+        freeTape(&tape);
+        if (retcode != CSIP_RETCODE_OK)
+        {
+            break;
+        }
 
-        // we do not need to remember this variable anymore nor the objcons
-        SCIP_in_CSIP(SCIPreleaseVar(scip, &model->objvar));
-        SCIP_in_CSIP(SCIPreleaseCons(scip, &model->objcons));
-        assert(model->objvar == NULL);
-        assert(model->objcons == NULL);
+        i = nextCons(reader, CSIP_CONSTYPE_NONLINEAR, i);
+        (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "c%d", i);
+        retcode = retCodeSCIPtoCSIP(SCIPcreateConsBasicNonlinear(scip,
+                                    &reader->conss[i], name, 0, NULL, NULL, 1, &tree, NULL,
+                                    lhss[k], rhss[k]));
+        (void) SCIPexprtreeFree(&tree);
     }
 
-    return CSIP_RETCODE_OK;
+    free(lhss);
+    free(rhss);
+
+    return retcode;
 }
 
-CSIP_RETCODE CSIPsetQuadObj(CSIP_MODEL *model, int numlinindices,
-                            int *linindices, double *lincoefs, int numquadterms,
-                            int *quadrowindices, int *quadcolindices,
-                            double *quadcoefs)
+// write the variables and lower bounds of the nrows semicontinuous variables
+static
+CSIP_RETCODE writeSemicontinuousBlock(CSIP_WRITER *writer, CSIP_MODEL *model,
+                                      const int *constypes, int nrows,
+                                      const int *varindex)
 {
-    int nprods;
-    int i;
-    int opidx;
-    int nops;
-    int nchildren;
-    CSIP_OP *ops;
-    int *children;
-    int *begin;
-    int *prodindices;
-    double *values;
-
-    // build the expression representation of a quadratic
-    // there are: numlinindices VARIDX, CONST and PROD for the linear part
-    // nquadterms VARIDX, VARIDX, CONST and PROD for the quadratic part
-    // So there are 3*numlindices + 4*nquadterms operators plus 1 (the sum)
-    // Number of children: each VARIDX and CONST contribute with one:
-    // nchildren >= 2*numlinindices + 3*nquadterms
-    // Then each PROD in numlinindices contribute with 2 and in nquadterms with 3
-    // nchildren >= 4*numlinindices + 6*nquadterms
-    // The final sum has as many children as products are there, nlinind + nquadterms
-    // nchildren = 5*numlinindices + 7*nquadterms
-    // NOTE: we will need to store the indices of the PROD operators
-    //       and all coefs in a single array `values`
-    nprods = numquadterms + numlinindices;
-    nchildren = 5 * numlinindices + 7 * numquadterms;
-    nops = 3 * numlinindices + 4 * numquadterms + 1;
-
-    ops = (int *) malloc(nops * sizeof(CSIP_OP));
-    children = (int *) malloc(nchildren * sizeof(int));
-    begin = (int *) malloc((nops + 1) * sizeof(int));
-    values = (double *) malloc(nprods * sizeof(double));
-    prodindices = (int *) malloc(nprods * sizeof(int));
-
-    begin[0] = 0;
-    opidx = -1;
-    // linear part
-    for (i = 0; i < numlinindices; ++i)
+    SCIP *scip = model->scip;
+    int *indices;
+    double *lowerbounds;
+    int k = 0;
+    SCIP_Bool ok;
+
+    indices = (int *) malloc(MAX(nrows, 1) * sizeof(int));
+    lowerbounds = (double *) malloc(MAX(nrows, 1) * sizeof(double));
+    if (indices == NULL || lowerbounds == NULL)
     {
-        // variable
-        ++opidx;
-        ops[opidx] = VARIDX;
-        begin[opidx + 1] = begin[opidx] + 1; // where its children end
-        children[begin[opidx]] = linindices[i]; //children
-
-        // next operator: coef
-        ++opidx;
-        ops[opidx] = CONST;
-        begin[opidx + 1] = begin[opidx] + 1;
-        children[begin[opidx]] = i;
-        values[i] = lincoefs[i];
-
-        // next operator: PROD between coef and variable
-        ++opidx;
-        ops[opidx] = PROD;
-        begin[opidx + 1] = begin[opidx] + 2;
-        children[begin[opidx]] = opidx - 2;
-        children[begin[opidx] + 1] = opidx - 1;
-
-        prodindices[i] = opidx;
-    }
-    // quadratic part
-    for (i = 0; i < numquadterms; ++i)
+        free(indices);
+        free(lowerbounds);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+
+    for (int i = 0; i < model->nconss; ++i)
     {
-        // variable 1
-        ++opidx;
-        ops[opidx] = VARIDX;
-        begin[opidx + 1] = begin[opidx] + 1; // where its children end
-        children[begin[opidx]] = quadrowindices[i]; //children
+        if (constypes[i] == CSIP_CONSTYPE_SEMICONTINUOUS)
+        {
+            SCIP_CONS *cons = model->conss[i];
 
-        // variable 2
-        ++opidx;
-        ops[opidx] = VARIDX;
-        begin[opidx + 1] = begin[opidx] + 1; // where its children end
-        children[begin[opidx]] = quadcolindices[i]; //children
+            getVarIndices(varindex, 1, SCIPgetVarsBounddisjunction(scip, cons),
+                          &indices[k]);
+            lowerbounds[k] = SCIPgetBoundsBounddisjunction(scip, cons)[1];
+            ++k;
+        }
+    }
 
-        // coef
-        ++opidx;
-        ops[opidx] = CONST;
-        begin[opidx + 1] = begin[opidx] + 1;
-        children[begin[opidx]] = i + numlinindices;
-        values[i + numlinindices] = quadcoefs[i];
+    ok = writeInts(writer, indices, nrows)
+         && writeReals(writer, lowerbounds, nrows);
+    free(indices);
+    free(lowerbounds);
 
-        // next operator: PROD between var1, var2 and coef
-        ++opidx;
-        ops[opidx] = PROD;
-        begin[opidx + 1] = begin[opidx] + 3;
-        children[begin[opidx]] = opidx - 3;
-        children[begin[opidx] + 1] = opidx - 2;
-        children[begin[opidx] + 2] = opidx - 1;
+    return ok ? CSIP_RETCODE_OK : CSIP_RETCODE_ERROR;
+}
 
-        prodindices[i + numlinindices] = opidx;
-    }
+/* create the nrows constraints of a block written by writeSemicontinuousBlock,
+ * see CSIPaddSemicontinuous
+ */
+static
+CSIP_RETCODE readSemicontinuousBlock(CSIP_READER *reader, CSIP_MODEL *model,
+                                     int nrows)
+{
+    SCIP *scip = model->scip;
+    SCIP_BOUNDTYPE boundtypes[2] = {SCIP_BOUNDTYPE_UPPER, SCIP_BOUNDTYPE_LOWER};
+    int *indices = NULL;
+    double *lowerbounds = NULL;
+    CSIP_RETCODE retcode;
 
-    // sum all PRODs
-    ++opidx;
-    ops[opidx] = SUM;
-    begin[opidx + 1] = begin[opidx] + nprods;
-    for (i = 0; i < nprods; ++i)
+    retcode = readIntArray(reader, nrows, &indices);
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readRealArray(reader, nrows, &lowerbounds);
+    }
+    if (retcode == CSIP_RETCODE_OK
+            && !areVarIndices(indices, nrows, model->nvars))
     {
-        children[begin[opidx] + i] = prodindices[i];
+        retcode = CSIP_RETCODE_ERROR;
     }
 
-    CSIP_CALL(CSIPsetNonlinearObj(model, nops, ops, children, begin, values));
+    for (int k = 0, i = 0; retcode == CSIP_RETCODE_OK && k < nrows; ++k, ++i)
+    {
+        SCIP_VAR *vars[2];
+        double bounds[2] = {0.0, lowerbounds[k]};
+        char name[SCIP_MAXSTRLEN];
 
-    // free everything
-    free(ops);
-    free(children);
-    free(begin);
-    free(values);
-    free(prodindices);
+        if (!isValidSemicontinuous(model, indices[k], lowerbounds[k]))
+        {
+            retcode = CSIP_RETCODE_ERROR;
+            break;
+        }
+        vars[0] = model->vars[indices[k]];
+        vars[1] = vars[0];
 
-    return CSIP_RETCODE_OK;
+        i = nextCons(reader, CSIP_CONSTYPE_SEMICONTINUOUS, i);
+        (void) SCIPsnprintf(name, SCIP_MAXSTRLEN, "c%d", i);
+        retcode = retCodeSCIPtoCSIP(SCIPcreateConsBasicBounddisjunction(scip,
+                                    &reader->conss[i], name, 2, vars, boundtypes, bounds));
+    }
+
+    free(indices);
+    free(lowerbounds);
+
+    return retcode;
 }
 
-CSIP_RETCODE CSIPsetNonlinearObj(
-    CSIP_MODEL *model, int nops, CSIP_OP *ops, int *children, int *begin,
-    double *values)
+static
+CSIP_RETCODE writeModelData(CSIP_WRITER *file, CSIP_MODEL *model)
 {
-    SCIP *scip;
-    SCIP_EXPRTREE *tree;
-    SCIP_CONS *cons;
+    SCIP *scip = model->scip;
+    int *varindex;
+    int *types;
+    int *constypes;
+    double *bounds;
+    int header[5];
+    int nrows[CSIP_NCONSTYPES] = {0};
+    int hasnlobj;
+    int ninactive = 0;
+    SCIP_Bool ok;
+    CSIP_RETCODE retcode = CSIP_RETCODE_OK;
+
+    for (int i = 0; i < model->nconss; ++i)
+    {
+        ninactive += !model->consactive[i];
+    }
 
-    // get scip, free transform and remove old objective if any
-    scip = model->scip;
-    SCIP_in_CSIP(SCIPfreeTransform(scip));
+    header[0] = CSIP_FILE_VERSION;
+    header[1] = model->nvars;
+    header[2] = model->nconss;
+    header[3] = SCIPgetObjsense(scip) == SCIP_OBJSENSE_MAXIMIZE ? -1 : 1;
+    header[4] = ninactive;
+    ok = writeBytes(file, CSIP_FILE_MAGIC, 8) && writeInts(file, header, 5);
+
+    // variables: lower bounds, upper bounds, objective, types
+    bounds = (double *) malloc(MAX(model->nvars, 1) * sizeof(double));
+    types = (int *) malloc(MAX(model->nvars, 1) * sizeof(int));
+    if (bounds == NULL || types == NULL)
+    {
+        free(bounds);
+        free(types);
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    for (int i = 0; i < model->nvars; ++i)
+    {
+        bounds[i] = SCIPvarGetLbOriginal(model->vars[i]);
+    }
+    ok = ok && writeReals(file, bounds, model->nvars);
+    for (int i = 0; i < model->nvars; ++i)
+    {
+        bounds[i] = SCIPvarGetUbOriginal(model->vars[i]);
+    }
+    ok = ok && writeReals(file, bounds, model->nvars);
+    for (int i = 0; i < model->nvars; ++i)
+    {
+        bounds[i] = SCIPvarGetObj(model->vars[i]);
+        types[i] = CSIPgetVarType(model, i);
+    }
+    ok = ok && writeReals(file, bounds, model->nvars)
+         && writeInts(file, types, model->nvars);
+    free(bounds);
+    free(types);
 
-    if (model->objvar != NULL)
+    constypes = (int *) malloc(MAX(model->nconss, 1) * sizeof(int));
+    if (constypes == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    for (int i = 0; i < model->nconss; ++i)
     {
-        SCIP_in_CSIP(SCIPchgVarObj(scip, model->objvar, 0.0));
-        SCIP_in_CSIP(SCIPchgVarLb(scip, model->objvar, -SCIPinfinity(scip)));
-        SCIP_in_CSIP(SCIPchgVarUb(scip, model->objvar, SCIPinfinity(scip)));
+        constypes[i] = getConsType(model->conss[i]);
+        if (constypes[i] < 0)
+        {
+            free(constypes);
+            return CSIP_RETCODE_ERROR;
+        }
+        ++nrows[constypes[i]];
+    }
 
-        // we do not need to remember this variable anymore nor objcons
-        SCIP_in_CSIP(SCIPreleaseVar(scip, &model->objvar));
-        SCIP_in_CSIP(SCIPreleaseCons(scip, &model->objcons));
+    retcode = createVarIndexMap(model, &varindex);
+    if (retcode != CSIP_RETCODE_OK)
+    {
+        free(constypes);
+        return retcode;
     }
-    assert(model->objvar == NULL);
-    assert(model->objcons == NULL);
 
-    // do nothing more if we received an empty expression tree
-    assert(nops >= 1);
-    if( nops == 1 && ops[0] != SCIP_EXPR_VARIDX )
+    // nonlinear objective, given by the epigraph constraint
+    hasnlobj = (model->objvar != NULL);
+    ok = ok && writeInts(file, &hasnlobj, 1);
+    if (ok && hasnlobj)
     {
-       return CSIP_RETCODE_OK;
+        retcode = writeTape(file, SCIPgetExprtreesNonlinear(
+                                scip, model->objcons)[0], varindex);
     }
 
-    CSIP_CALL(createExprtree(model, nops, ops, children, begin,
-                             values, &tree));
+    ok = ok && writeInts(file, constypes, model->nconss);
+    for (int t = 0; ok && retcode == CSIP_RETCODE_OK && t < CSIP_NCONSTYPES;
+            ++t)
+    {
+        switch (t)
+        {
+        case CSIP_CONSTYPE_QUADRATIC:
+            retcode = writeQuadraticBlock(file, model, constypes, nrows[t],
+                                          varindex);
+            break;
+        case CSIP_CONSTYPE_NONLINEAR:
+            retcode = writeNonlinearBlock(file, model, constypes, nrows[t],
+                                          varindex);
+            break;
+        case CSIP_CONSTYPE_SEMICONTINUOUS:
+            retcode = writeSemicontinuousBlock(file, model, constypes,
+                                               nrows[t], varindex);
+            break;
+        default:
+            retcode = writeRowBlock(file, model, constypes, t, nrows[t],
+                                    varindex);
+        }
+    }
+    free(varindex);
+    free(constypes);
 
-    // create nonlinear objective constraint
-    SCIP_in_CSIP(SCIPcreateConsBasicNonlinear(scip, &cons,
-                 "nonlin_obj", 0, NULL, NULL, 1, &tree, NULL,
-                 -SCIPinfinity(scip), 0.0));
+    // indices of inactive constraints
+    for (int i = 0; ok && i < model->nconss; ++i)
+    {
+        if (!model->consactive[i])
+        {
+            ok = writeInts(file, &i, 1);
+        }
+    }
 
-    // add objvar to nonlinear objective
-    SCIP_in_CSIP(SCIPcreateVarBasic(scip, &model->objvar, NULL,
-                                    -SCIPinfinity(scip), SCIPinfinity(scip), 1.0,
-                                    SCIP_VARTYPE_CONTINUOUS));
-    SCIP_in_CSIP(SCIPaddVar(scip, model->objvar));
-    SCIP_in_CSIP(SCIPaddLinearVarNonlinear(scip, cons, model->objvar, -1.0));
+    return ok ? retcode : CSIP_RETCODE_ERROR;
+}
 
-    // add objective constraint and remember it
-    SCIP_in_CSIP(SCIPaddCons(scip, cons));
-    model->objcons = cons;
-    model->objtype = CSIP_OBJTYPE_NONLINEAR;
+CSIP_RETCODE CSIPwriteModel(CSIP_MODEL *model, const char *filename)
+{
+    CSIP_WRITER writer;
+    CSIP_RETCODE retcode;
 
-    // the created constraint is correct if sense is minimize, otherwise we
-    // have to correct it
-    if (SCIPgetObjsense(model->scip) == SCIP_OBJSENSE_MAXIMIZE)
+    writer.file = fopen(filename, "wb");
+    if (writer.file == NULL)
     {
-        CSIP_CALL(correctObjectiveFunction(model));
+        return CSIP_RETCODE_ERROR;
     }
 
-    // free memory
-    SCIP_in_CSIP(SCIPexprtreeFree(&tree));
+    retcode = writeModelData(&writer, model);
 
-    return CSIP_RETCODE_OK;
+    if (fclose(writer.file) != 0)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    return retcode;
 }
 
-CSIP_RETCODE CSIPsetSenseMinimize(CSIP_MODEL *model)
+CSIP_RETCODE CSIPgetFingerprint(CSIP_MODEL *model,
+                                unsigned long long *fingerprint)
 {
-    SCIP_in_CSIP(SCIPfreeTransform(model->scip));
-
-    if (SCIPgetObjsense(model->scip) != SCIP_OBJSENSE_MINIMIZE)
+    // the model is only hashed again after a change
+    if (!model->hasfingerprint)
     {
-        SCIP_in_CSIP(SCIPsetObjsense(model->scip, SCIP_OBJSENSE_MINIMIZE));
-        CSIP_CALL(correctObjectiveFunction(model));
+        CSIP_WRITER writer;
+        CSIP_RETCODE retcode;
+
+        writer.file = NULL;
+        writer.hash = 14695981039346656037ull;
+        retcode = writeModelData(&writer, model);
+        if (retcode != CSIP_RETCODE_OK)
+        {
+            return retcode;
+        }
+        model->fingerprint = writer.hash;
+        model->hasfingerprint = TRUE;
     }
+    *fingerprint = model->fingerprint;
 
     return CSIP_RETCODE_OK;
 }
 
-CSIP_RETCODE CSIPsetSenseMaximize(CSIP_MODEL *model)
+// read the variables, the objective and the sense of the model
+static
+CSIP_RETCODE readVars(CSIP_READER *reader, CSIP_MODEL *model, int nvars,
+                      int sense)
 {
-    SCIP_in_CSIP(SCIPfreeTransform(model->scip));
+    double *lbs = NULL;
+    double *ubs = NULL;
+    double *objs = NULL;
+    int *types = NULL;
+    int hasnlobj;
+    CSIP_RETCODE retcode;
+
+    retcode = readRealArray(reader, nvars, &lbs);
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readRealArray(reader, nvars, &ubs);
+    }
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readRealArray(reader, nvars, &objs);
+    }
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readIntArray(reader, nvars, &types);
+    }
 
-    if (SCIPgetObjsense(model->scip) != SCIP_OBJSENSE_MAXIMIZE)
+    for (int i = 0; retcode == CSIP_RETCODE_OK && i < nvars; ++i)
     {
-        SCIP_in_CSIP(SCIPsetObjsense(model->scip, SCIP_OBJSENSE_MAXIMIZE));
-        CSIP_CALL(correctObjectiveFunction(model));
+        if (types[i] < CSIP_VARTYPE_BINARY
+                || types[i] > CSIP_VARTYPE_CONTINUOUS)
+        {
+            retcode = CSIP_RETCODE_ERROR;
+            break;
+        }
+        retcode = addVar(model, lbs[i], ubs[i], types[i], NULL, NULL);
+        if (retcode == CSIP_RETCODE_OK)
+        {
+            retcode = retCodeSCIPtoCSIP(SCIPchgVarObj(model->scip,
+                                        model->vars[i], objs[i]));
+        }
+    }
+    if (retcode == CSIP_RETCODE_OK && sense < 0)
+    {
+        retcode = CSIPsetSenseMaximize(model);
     }
 
-    return CSIP_RETCODE_OK;
-}
+    free(lbs);
+    free(ubs);
+    free(objs);
+    free(types);
 
-CSIP_RETCODE CSIPsolve(CSIP_MODEL *model)
-{
-    // add initial solution
-    if (model->initialsol != NULL)
+    // the epigraph is set up after the sense, so it is already correct
+    if (retcode == CSIP_RETCODE_OK
+            && (!readInts(reader, &hasnlobj, 1) || (hasnlobj != 0
+                    && hasnlobj != 1)))
     {
-        unsigned int stored;
-        SCIP_Bool initialsolpartial =
-            (SCIPsolGetOrigin(model->initialsol) == SCIP_SOLORIGIN_PARTIAL);
-
-        /* if objective is nonlinear, we need to extend the initial sol with
-         * the value of objvar. For this we need to change the objective
-         * constraint temporarily to an equality constraint. However the
-         * nonlinear contraint handler doesn't allow to change sides, so
-         * we have to create a brand new constraint to compute the violation
-         *
-         * This is not true if the user has given a partial sol, because then
-         * we can safely leave the value for the objval unspecified. In fact,
-         * that's preferred, because computing the violation might fail.
-         */
-        if (model->objcons != NULL && !initialsolpartial)
+        retcode = CSIP_RETCODE_ERROR;
+    }
+    if (retcode == CSIP_RETCODE_OK && hasnlobj)
+    {
+        CSIP_TAPE tape;
+
+        retcode = readTape(reader, nvars, &tape);
+        if (retcode == CSIP_RETCODE_OK)
         {
-            SCIP_CONS* tempcons;
-            SCIP_Real objvarval;
-            SCIP_EXPRTREE *tree;
+            retcode = CSIPsetNonlinearObj(model, tape.nops, tape.ops,
+                                          tape.children, tape.begin,
+                                          tape.values);
+            freeTape(&tape);
+        }
+    }
 
-            /* we do not care about the sign of the expression tree, since
-             * tempcons is equality and this already gives the correct sign for
-             * objvarval */
-            tree = SCIPgetExprtreesNonlinear(model->scip, model->objcons)[0];
-            SCIP_in_CSIP(SCIPcreateConsBasicNonlinear(model->scip, &tempcons,
-                     "temp_nonlin_obj", 0, NULL, NULL, 1, &tree, NULL,
-                     0.0, 0.0));
-            SCIP_in_CSIP(SCIPgetViolationNonlinear(model->scip, tempcons,
-                     model->initialsol, &objvarval) );
+    return retcode;
+}
 
-            SCIP_in_CSIP(SCIPreleaseCons(model->scip, &tempcons));
+/* read the constraints block by block and add them to the model in index
+ * order once all of them were read; the ninactive inactive constraints are
+ * given in increasing order
+ */
+static
+CSIP_RETCODE readConss(CSIP_READER *reader, CSIP_MODEL *model, int nconss,
+                       int ninactive)
+{
+    int nrows[CSIP_NCONSTYPES] = {0};
+    int *inactive = NULL;
+    CSIP_RETCODE retcode;
 
-            SCIP_in_CSIP(SCIPsetSolVals(model->scip, model->initialsol, 1,
-                     &model->objvar, &objvarval));
+    retcode = readIntArray(reader, nconss, &reader->constypes);
+    for (int i = 0; retcode == CSIP_RETCODE_OK && i < nconss; ++i)
+    {
+        if (reader->constypes[i] < 0
+                || reader->constypes[i] >= CSIP_NCONSTYPES)
+        {
+            retcode = CSIP_RETCODE_ERROR;
+            break;
+        }
+        ++nrows[reader->constypes[i]];
+    }
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        reader->conss = (SCIP_CONS **) calloc(MAX(nconss, 1),
+                                              sizeof(SCIP_CONS *));
+        if (reader->conss == NULL)
+        {
+            retcode = CSIP_RETCODE_NOMEMORY;
         }
+    }
 
+    for (int t = 0; retcode == CSIP_RETCODE_OK && t < CSIP_NCONSTYPES; ++t)
+    {
+        switch (t)
+        {
+        case CSIP_CONSTYPE_QUADRATIC:
+            retcode = readQuadraticBlock(reader, model, nrows[t]);
+            break;
+        case CSIP_CONSTYPE_NONLINEAR:
+            retcode = readNonlinearBlock(reader, model, nrows[t]);
+            break;
+        case CSIP_CONSTYPE_SEMICONTINUOUS:
+            retcode = readSemicontinuousBlock(reader, model, nrows[t]);
+            break;
+        default:
+            retcode = readRowBlock(reader, model, t, nrows[t]);
+        }
+    }
 
-        SCIP_in_CSIP(SCIPaddSolFree(model->scip, &model->initialsol, &stored));
+    if (retcode == CSIP_RETCODE_OK)
+    {
+        retcode = readIntArray(reader, ninactive, &inactive);
+    }
+    for (int i = 0; retcode == CSIP_RETCODE_OK && i < ninactive; ++i)
+    {
+        if (inactive[i] < (i == 0 ? 0 : inactive[i - 1] + 1)
+                || inactive[i] >= nconss)
+        {
+            retcode = CSIP_RETCODE_ERROR;
+        }
     }
 
-    SCIP_in_CSIP(SCIPsolve(model->scip));
+    // the model takes over the constraints
+    for (int i = 0; retcode == CSIP_RETCODE_OK && i < nconss; ++i)
+    {
+        retcode = addCons(model, reader->conss[i], NULL);
+        reader->conss[i] = NULL;
+    }
+    if (retcode == CSIP_RETCODE_OK && ninactive > 0)
+    {
+        retcode = CSIPsetConsActive(model, ninactive, inactive, FALSE);
+    }
 
-    return CSIP_RETCODE_OK;
-}
+    for (int i = 0; reader->conss != NULL && i < nconss; ++i)
+    {
+        if (reader->conss[i] != NULL)
+        {
+            (void) SCIPreleaseCons(model->scip, &reader->conss[i]);
+        }
+    }
+    free(reader->conss);
+    free(reader->constypes);
+    free(inactive);
 
-CSIP_RETCODE CSIPinterrupt(CSIP_MODEL *model)
-{
-    SCIP_in_CSIP(SCIPinterruptSolve(model->scip));
-    return CSIP_RETCODE_OK;
+    return retcode;
 }
 
-CSIP_STATUS CSIPgetStatus(CSIP_MODEL *model)
+static
+CSIP_RETCODE readModelData(CSIP_READER *reader, CSIP_MODEL *model)
 {
-    switch (SCIPgetStatus(model->scip))
+    char magic[8];
+    int header[5];
+    CSIP_RETCODE retcode;
+
+    if (!readBytes(reader, magic, 8, 1)
+            || memcmp(magic, CSIP_FILE_MAGIC, 8) != 0
+            || !readInts(reader, header, 5) || header[0] != CSIP_FILE_VERSION
+            || header[1] < 0 || header[2] < 0
+            || (header[3] != 1 && header[3] != -1)
+            || header[4] < 0 || header[4] > header[2])
     {
-    case SCIP_STATUS_UNKNOWN:
-        return CSIP_STATUS_UNKNOWN;
-    case SCIP_STATUS_USERINTERRUPT:
-        return CSIP_STATUS_USERLIMIT;
-    case SCIP_STATUS_NODELIMIT:
-        return CSIP_STATUS_NODELIMIT;
-    case SCIP_STATUS_TOTALNODELIMIT:
-        return CSIP_STATUS_NODELIMIT;
-    case SCIP_STATUS_STALLNODELIMIT:
-        return CSIP_STATUS_USERLIMIT;
-    case SCIP_STATUS_TIMELIMIT:
-        return CSIP_STATUS_TIMELIMIT;
-    case SCIP_STATUS_MEMLIMIT:
-        return CSIP_STATUS_MEMLIMIT;
-    case SCIP_STATUS_GAPLIMIT:
-        return CSIP_STATUS_USERLIMIT;
-    case SCIP_STATUS_SOLLIMIT:
-        return CSIP_STATUS_USERLIMIT;
-    case SCIP_STATUS_BESTSOLLIMIT:
-        return CSIP_STATUS_USERLIMIT;
-    case SCIP_STATUS_RESTARTLIMIT:
-        return CSIP_STATUS_USERLIMIT;
-    case SCIP_STATUS_OPTIMAL:
-        return CSIP_STATUS_OPTIMAL;
-    case SCIP_STATUS_INFEASIBLE:
-        return CSIP_STATUS_INFEASIBLE;
-    case SCIP_STATUS_UNBOUNDED:
-        return CSIP_STATUS_UNBOUNDED;
-    case SCIP_STATUS_INFORUNBD:
-        return CSIP_STATUS_INFORUNBD;
-    default:
-        return CSIP_STATUS_UNKNOWN;
+        return CSIP_RETCODE_ERROR;
     }
-}
 
-double CSIPgetObjValue(CSIP_MODEL *model)
-{
-    SCIP_SOL *sol = SCIPgetBestSol(model->scip);
-    if (sol == NULL)
+    retcode = readVars(reader, model, header[1], header[3]);
+    if (retcode == CSIP_RETCODE_OK)
     {
-        return CSIP_RETCODE_ERROR;
+        retcode = readConss(reader, model, header[2], header[4]);
     }
 
-    return SCIPgetSolOrigObj(model->scip, sol);
-}
+    // nothing may follow the inactive constraints
+    if (retcode == CSIP_RETCODE_OK && reader->remaining != 0)
+    {
+        retcode = CSIP_RETCODE_ERROR;
+    }
 
-double CSIPgetObjBound(CSIP_MODEL *model)
-{
-    return SCIPgetDualbound(model->scip);
+    return retcode;
 }
 
-
-CSIP_RETCODE CSIPgetVarValues(CSIP_MODEL *model, double *output)
+CSIP_RETCODE CSIPreadModel(const char *filename, CSIP_MODEL **modelptr)
 {
-    int i;
-    SCIP *scip;
-    SCIP_VAR *var;
-
-    scip = model->scip;
+    CSIP_READER reader;
+    CSIP_RETCODE retcode;
 
-    if (SCIPgetBestSol(scip) == NULL)
+    *modelptr = NULL;
+    reader.file = fopen(filename, "rb");
+    if (reader.file == NULL)
     {
         return CSIP_RETCODE_ERROR;
     }
+    reader.constypes = NULL;
+    reader.conss = NULL;
 
-    for (i = 0; i < model->nvars; ++i)
+    // the size of the file bounds all sizes read from it
+    if (fseek(reader.file, 0, SEEK_END) != 0
+            || (reader.remaining = ftell(reader.file)) < 0
+            || fseek(reader.file, 0, SEEK_SET) != 0)
     {
-        var = model->vars[i];
-        output[i] = SCIPgetSolVal(scip, SCIPgetBestSol(scip), var);
+        fclose(reader.file);
+        return CSIP_RETCODE_ERROR;
     }
 
-    return CSIP_RETCODE_OK;
-}
-
-// Get the type of a parameter
-CSIP_PARAMTYPE CSIPgetParamType(CSIP_MODEL *model, const char *name)
-{
-    SCIP_PARAM *param;
-
-    param = SCIPgetParam(model->scip, name);
-    if (param == NULL)
+    retcode = CSIPcreateModel(modelptr);
+    if (retcode == CSIP_RETCODE_OK)
     {
-        return CSIP_PARAMTYPE_NOTAPARAM;
+        retcode = readModelData(&reader, *modelptr);
     }
-    else
+    fclose(reader.file);
+
+    // nothing is kept of invalid files
+    if (retcode != CSIP_RETCODE_OK && *modelptr != NULL)
     {
-        return SCIPparamGetType(param);
+        (void) CSIPfreeModel(*modelptr);
+        *modelptr = NULL;
     }
-}
 
-CSIP_RETCODE CSIPsetBoolParam(
-    CSIP_MODEL *model, const char *name, int value)
-{
-    SCIP_in_CSIP(SCIPsetBoolParam(model->scip, name, value));
-    return CSIP_RETCODE_OK;
+    return retcode;
 }
 
-CSIP_RETCODE CSIPsetIntParam(
-    CSIP_MODEL *model, const char *name, int value)
-{
-    SCIP_in_CSIP(SCIPsetIntParam(model->scip, name, value));
-    return CSIP_RETCODE_OK;
-}
+/*
+ * MPS reader
+ *
+ * The file is mapped into memory and parsed in a single pass. Rows and
+ * columns are looked up by name in hash tables that point into the mapped
+ * file. The coefficients are collected column by column and transposed at
+ * the end, so that each constraint is created with all its coefficients.
+ */
 
-CSIP_RETCODE CSIPsetLongintParam(
-    CSIP_MODEL *model, const char *name, long long value)
-{
-    SCIP_in_CSIP(SCIPsetLongintParam(model->scip, name, value));
-    return CSIP_RETCODE_OK;
-}
+/* sections of MPS files */
+#define MPS_NONE 0
+#define MPS_NAME 1
+#define MPS_OBJSENSE 2
+#define MPS_ROWS 3
+#define MPS_COLUMNS 4
+#define MPS_RHS 5
+#define MPS_RANGES 6
+#define MPS_BOUNDS 7
+#define MPS_ENDATA 8
 
-CSIP_RETCODE CSIPsetRealParam(
-    CSIP_MODEL *model, const char *name, double value)
-{
-    SCIP_in_CSIP(SCIPsetRealParam(model->scip, name, value));
-    return CSIP_RETCODE_OK;
-}
+/* special values in the row name table */
+#define MPS_OBJROW -2
+#define MPS_FREEROW -3
 
-CSIP_RETCODE CSIPsetCharParam(
-    CSIP_MODEL *model, const char *name, char value)
-{
-    SCIP_in_CSIP(SCIPsetCharParam(model->scip, name, value));
-    return CSIP_RETCODE_OK;
-}
+#define MPS_MAXTOKENS 8
 
-CSIP_RETCODE CSIPsetStringParam(
-    CSIP_MODEL *model, const char *name, const char *value)
+typedef struct
 {
-    SCIP_in_CSIP(SCIPsetStringParam(model->scip, name, value));
-    return CSIP_RETCODE_OK;
-}
+    const char *str;
+    int len;
+} CSIP_TOKEN;
 
-int CSIPgetNumVars(CSIP_MODEL *model)
+typedef struct
 {
-    return model->nvars;
-}
-
-int CSIPgetNumConss(CSIP_MODEL *model)
+    double infinity;
+    int section;
+    SCIP_Bool maximize;
+    SCIP_Bool hasobj;
+    SCIP_Bool intmarker;
+    int lastcol;
+
+    // rows: type ('L', 'G' or 'E'), right hand side and range
+    int nrows;
+    int rowssize;
+    char *rowtypes;
+    double *rhss;
+    double *ranges;
+    CSIP_NAMETABLE rownames;
+
+    // columns: bounds, objective and type
+    int ncols;
+    int colssize;
+    double *lbs;
+    double *ubs;
+    double *objs;
+    int *types;
+    CSIP_NAMETABLE colnames;
+
+    // coefficients of the constraint matrix, in file order
+    size_t nentries;
+    size_t entriessize;
+    int *entryrows;
+    int *entrycols;
+    double *entryvals;
+} CSIP_MPS;
+
+static inline
+SCIP_Bool tokenIs(CSIP_TOKEN token, const char *str)
 {
-    return model->nconss;
+    return (int) strlen(str) == token.len
+           && memcmp(token.str, str, token.len) == 0;
 }
 
-CSIP_RETCODE CSIPsetInitialSolution(CSIP_MODEL *model, double *values)
+/* Parse a real number. Numbers with up to 15 significant digits and a small
+ * decimal exponent are computed exactly from their digits, all others are
+ * left to strtod.
+ */
+static
+SCIP_Bool parseReal(CSIP_TOKEN token, double *value)
 {
-    // are there missing values?
-    SCIP_Bool initialsolpartial = FALSE;
-    for(int i = 0; i < model->nvars; ++i)
+    static const double powers[] =
     {
-        SCIP_Real val = values[i];
-        if(val != val) // check for NaN
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char *p = token.str;
+    const char *end = token.str + token.len;
+    SCIP_Bool negative = FALSE;
+    unsigned long long mantissa = 0;
+    int ndigits = 0;
+    int nmantissadigits = 0;
+    int nexpdigits = 0;
+    int exponent = 0;
+    char buffer[64];
+    char *parsed;
+
+    if (p < end && (*p == '+' || *p == '-'))
+    {
+        negative = (*p == '-');
+        ++p;
+    }
+    for (; p < end && *p >= '0' && *p <= '9'; ++p)
+    {
+        mantissa = 10 * mantissa + (*p - '0');
+        ndigits += (mantissa > 0);
+        ++nmantissadigits;
+    }
+    if (p < end && *p == '.')
+    {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p)
         {
-            initialsolpartial = TRUE;
-            break;
+            mantissa = 10 * mantissa + (*p - '0');
+            ndigits += (mantissa > 0);
+            ++nmantissadigits;
+            --exponent;
         }
     }
-
-    // was solution already given?
-    if (model->initialsol != NULL)
+    if (p < end && (*p == 'e' || *p == 'E'))
     {
-        SCIP_in_CSIP(SCIPfreeSol(model->scip, &model->initialsol));
-    }
-    assert(model->initialsol == NULL);
+        SCIP_Bool negexp = FALSE;
+        int exp = 0;
 
-    // create new solution object
-    if(initialsolpartial)
-    {
-        SCIP_in_CSIP(SCIPcreatePartialSol(model->scip, &model->initialsol, NULL));
+        ++p;
+        if (p < end && (*p == '+' || *p == '-'))
+        {
+            negexp = (*p == '-');
+            ++p;
+        }
+        for (; p < end && *p >= '0' && *p <= '9' && exp < 10000; ++p)
+        {
+            exp = 10 * exp + (*p - '0');
+            ++nexpdigits;
+        }
+        exponent += negexp ? -exp : exp;
 
-        // give only the proper values, skip NaN
-        for(int i = 0; i < model->nvars; ++i)
+        // "1e" or "1e+" is not a number
+        if (nexpdigits == 0)
         {
-            SCIP_Real val = values[i];
-            if(val == val) // check for NaN
-            {
-                SCIP_in_CSIP(SCIPsetSolVal(model->scip, model->initialsol,
-                                           model->vars[i], val));
-            }
+            return FALSE;
         }
     }
-    else
-    {
-        SCIP_in_CSIP(SCIPcreateSol(model->scip, &model->initialsol, NULL));
 
-        // copy the given values
-        SCIP_in_CSIP(SCIPsetSolVals(model->scip, model->initialsol, model->nvars,
-                                    model->vars, values));
+    /* fast path: the mantissa and the power of ten are exact doubles; without
+     * mantissa digits (e.g., "-", "." or "e5"), only strtod may accept it */
+    if (p == end && nmantissadigits > 0 && ndigits <= 15 && exponent >= -22
+            && exponent <= 22)
+    {
+        *value = exponent < 0 ? mantissa / powers[-exponent]
+                 : mantissa * powers[exponent];
+        *value = negative ? -*value : *value;
+        return TRUE;
     }
 
-    // it will be given to SCIP in the CSIPsolve call
+    // slow path, also handles Inf and NaN
+    if (token.len >= (int) sizeof(buffer))
+    {
+        return FALSE;
+    }
+    memcpy(buffer, token.str, token.len);
+    buffer[token.len] = '\0';
+    *value = strtod(buffer, &parsed);
 
-    return CSIP_RETCODE_OK;
+    return parsed == buffer + token.len;
 }
 
-void *CSIPgetInternalSCIP(CSIP_MODEL *model)
+static
+CSIP_RETCODE createMps(CSIP_MPS *mps, double infinity)
 {
-    return model->scip;
-}
-
+    CSIP_RETCODE rowretcode;
+    CSIP_RETCODE colretcode;
+
+    mps->infinity = infinity;
+    mps->section = MPS_NONE;
+    mps->maximize = FALSE;
+    mps->hasobj = FALSE;
+    mps->intmarker = FALSE;
+    mps->lastcol = -1;
+
+    mps->nrows = 0;
+    mps->rowssize = INITIALSIZE;
+    mps->rowtypes = (char *) malloc(INITIALSIZE * sizeof(char));
+    mps->rhss = (double *) malloc(INITIALSIZE * sizeof(double));
+    mps->ranges = (double *) malloc(INITIALSIZE * sizeof(double));
+
+    mps->ncols = 0;
+    mps->colssize = INITIALSIZE;
+    mps->lbs = (double *) malloc(INITIALSIZE * sizeof(double));
+    mps->ubs = (double *) malloc(INITIALSIZE * sizeof(double));
+    mps->objs = (double *) malloc(INITIALSIZE * sizeof(double));
+    mps->types = (int *) malloc(INITIALSIZE * sizeof(int));
+
+    mps->nentries = 0;
+    mps->entriessize = INITIALSIZE;
+    mps->entryrows = (int *) malloc(INITIALSIZE * sizeof(int));
+    mps->entrycols = (int *) malloc(INITIALSIZE * sizeof(int));
+    mps->entryvals = (double *) malloc(INITIALSIZE * sizeof(double));
+
+    // always create both tables, so that freeMps can clean up after a failure
+    rowretcode = createNameTable(&mps->rownames, INITIALSIZE);
+    colretcode = createNameTable(&mps->colnames, INITIALSIZE);
+
+    if (mps->rowtypes == NULL || mps->rhss == NULL || mps->ranges == NULL
+            || mps->lbs == NULL || mps->ubs == NULL || mps->objs == NULL
+            || mps->types == NULL || mps->entryrows == NULL
+            || mps->entrycols == NULL || mps->entryvals == NULL
+            || rowretcode != CSIP_RETCODE_OK || colretcode != CSIP_RETCODE_OK)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
 
-/*
- * Constraint Handler
- */
+    return CSIP_RETCODE_OK;
+}
 
-/* constraint handler data */
-struct SCIP_ConshdlrData
+static
+void freeMps(CSIP_MPS *mps)
 {
-    CSIP_MODEL *model;
-    CSIP_LAZYCALLBACK callback;
-    void *userdata;
-    SCIP_Bool checkonly;
-    SCIP_Bool feasible;
-    SCIP_SOL *sol;
-};
+    free(mps->rowtypes);
+    free(mps->rhss);
+    free(mps->ranges);
+    free(mps->lbs);
+    free(mps->ubs);
+    free(mps->objs);
+    free(mps->types);
+    free(mps->entryrows);
+    free(mps->entrycols);
+    free(mps->entryvals);
+    freeNameTable(&mps->rownames);
+    freeNameTable(&mps->colnames);
+}
 
-SCIP_DECL_CONSFREE(consFreeLazy)
+static
+CSIP_RETCODE readMpsRow(CSIP_MPS *mps, int ntokens, CSIP_TOKEN *tokens)
 {
-    SCIP_CONSHDLRDATA *conshdlrdata;
-
-    conshdlrdata = SCIPconshdlrGetData(conshdlr);
-    assert(conshdlrdata != NULL);
+    char type;
 
-    SCIPfreeMemory(scip, &conshdlrdata);
-
-    SCIPconshdlrSetData(conshdlr, NULL);
-
-    return SCIP_OKAY;
-}
+    if (ntokens != 2 || tokens[0].len != 1
+            || findName(&mps->rownames, tokens[1].str, tokens[1].len) != -1)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
 
-SCIP_DECL_CONSENFOLP(consEnfolpLazy)
-{
-    SCIP_CONSHDLRDATA *conshdlrdata;
+    type = tokens[0].str[0];
+    if (type == 'N')
+    {
+        // the first free row is the objective, others are ignored
+        CSIP_CALL(insertName(&mps->rownames, tokens[1].str, tokens[1].len,
+                             mps->hasobj ? MPS_FREEROW : MPS_OBJROW));
+        mps->hasobj = TRUE;
+        return CSIP_RETCODE_OK;
+    }
+    if (type != 'L' && type != 'G' && type != 'E')
+    {
+        return CSIP_RETCODE_ERROR;
+    }
 
-    *result = SCIP_FEASIBLE;
+    // do we need to resize?
+    if (mps->nrows >= mps->rowssize)
+    {
+        mps->rowssize = GROWFACTOR * mps->rowssize;
+        mps->rowtypes = (char *) realloc(mps->rowtypes,
+                                         mps->rowssize * sizeof(char));
+        mps->rhss = (double *) realloc(mps->rhss,
+                                       mps->rowssize * sizeof(double));
+        mps->ranges = (double *) realloc(mps->ranges,
+                                         mps->rowssize * sizeof(double));
+        if (mps->rowtypes == NULL || mps->rhss == NULL || mps->ranges == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+    }
 
-    conshdlrdata = SCIPconshdlrGetData(conshdlr);
-    conshdlrdata->checkonly = FALSE;
-    conshdlrdata->feasible = TRUE;
+    mps->rowtypes[mps->nrows] = type;
+    mps->rhss[mps->nrows] = 0.0;
+    mps->ranges[mps->nrows] = 0.0;
+    CSIP_CALL(insertName(&mps->rownames, tokens[1].str, tokens[1].len,
+                         mps->nrows));
+    ++(mps->nrows);
 
-    CSIP_in_SCIP(conshdlrdata->callback(conshdlrdata->model,
-                                        conshdlrdata, conshdlrdata->userdata));
+    return CSIP_RETCODE_OK;
+}
 
-    if (!conshdlrdata->feasible)
+static
+CSIP_RETCODE addMpsEntry(CSIP_MPS *mps, int row, int col, double val)
+{
+    // do we need to resize?
+    if (mps->nentries >= mps->entriessize)
     {
-        *result = SCIP_CONSADDED;
+        mps->entriessize = GROWFACTOR * mps->entriessize;
+        mps->entryrows = (int *) realloc(mps->entryrows,
+                                         mps->entriessize * sizeof(int));
+        mps->entrycols = (int *) realloc(mps->entrycols,
+                                         mps->entriessize * sizeof(int));
+        mps->entryvals = (double *) realloc(mps->entryvals,
+                                            mps->entriessize * sizeof(double));
+        if (mps->entryrows == NULL || mps->entrycols == NULL
+                || mps->entryvals == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
     }
 
-    return SCIP_OKAY;
-}
+    mps->entryrows[mps->nentries] = row;
+    mps->entrycols[mps->nentries] = col;
+    mps->entryvals[mps->nentries] = val;
+    ++(mps->nentries);
 
-/* enfo pseudo solution just call enfo lp solution */
-SCIP_DECL_CONSENFOPS(consEnfopsLazy)
-{
-    return consEnfolpLazy(scip, conshdlr, conss, nconss, nusefulconss,
-                          solinfeasible, result);
+    return CSIP_RETCODE_OK;
 }
 
-/* check callback */
-SCIP_DECL_CONSCHECK(consCheckLazy)
+static
+CSIP_RETCODE readMpsColumn(CSIP_MPS *mps, int ntokens, CSIP_TOKEN *tokens)
 {
-    SCIP_CONSHDLRDATA *conshdlrdata;
+    int col;
 
-    *result = SCIP_FEASIBLE;
+    // integer markers
+    if (ntokens == 3 && tokenIs(tokens[1], "'MARKER'"))
+    {
+        if (tokenIs(tokens[2], "'INTORG'"))
+        {
+            mps->intmarker = TRUE;
+        }
+        else if (tokenIs(tokens[2], "'INTEND'"))
+        {
+            mps->intmarker = FALSE;
+        }
+        else
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+        return CSIP_RETCODE_OK;
+    }
 
-    conshdlrdata = SCIPconshdlrGetData(conshdlr);
-    conshdlrdata->checkonly = TRUE;
-    conshdlrdata->feasible = TRUE;
-    conshdlrdata->sol = sol;
+    if (ntokens != 3 && ntokens != 5)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    // columns are usually given in one block, so first try the last one
+    col = mps->lastcol;
+    if (col < 0 || findName(&mps->colnames, tokens[0].str, tokens[0].len) != col)
+    {
+        col = findName(&mps->colnames, tokens[0].str, tokens[0].len);
+    }
+    if (col < 0)
+    {
+        // do we need to resize?
+        if (mps->ncols >= mps->colssize)
+        {
+            mps->colssize = GROWFACTOR * mps->colssize;
+            mps->lbs = (double *) realloc(mps->lbs,
+                                          mps->colssize * sizeof(double));
+            mps->ubs = (double *) realloc(mps->ubs,
+                                          mps->colssize * sizeof(double));
+            mps->objs = (double *) realloc(mps->objs,
+                                           mps->colssize * sizeof(double));
+            mps->types = (int *) realloc(mps->types,
+                                         mps->colssize * sizeof(int));
+            if (mps->lbs == NULL || mps->ubs == NULL || mps->objs == NULL
+                    || mps->types == NULL)
+            {
+                return CSIP_RETCODE_NOMEMORY;
+            }
+        }
 
-    CSIP_in_SCIP(conshdlrdata->callback(conshdlrdata->model,
-                                        conshdlrdata, conshdlrdata->userdata));
+        col = mps->ncols;
+        mps->lbs[col] = 0.0;
+        mps->ubs[col] = mps->infinity;
+        mps->objs[col] = 0.0;
+        mps->types[col] = mps->intmarker ? CSIP_VARTYPE_INTEGER
+                          : CSIP_VARTYPE_CONTINUOUS;
+        CSIP_CALL(insertName(&mps->colnames, tokens[0].str, tokens[0].len,
+                             col));
+        ++(mps->ncols);
+    }
+    mps->lastcol = col;
 
-    if (!conshdlrdata->feasible)
+    for (int t = 1; t < ntokens; t += 2)
     {
-        *result = SCIP_INFEASIBLE;
+        int row = findName(&mps->rownames, tokens[t].str, tokens[t].len);
+        double val;
+
+        if (row == -1 || !parseReal(tokens[t + 1], &val))
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+        if (row == MPS_OBJROW)
+        {
+            mps->objs[col] = val;
+        }
+        else if (row >= 0 && val != 0.0)
+        {
+            CSIP_CALL(addMpsEntry(mps, row, col, val));
+        }
     }
 
-    return SCIP_OKAY;
+    return CSIP_RETCODE_OK;
 }
 
-/* locks callback */
-SCIP_DECL_CONSLOCK(consLockLazy)
+// read a line of the RHS or RANGES section
+static
+CSIP_RETCODE readMpsRhs(CSIP_MPS *mps, int ntokens, CSIP_TOKEN *tokens)
 {
-    int i;
-    SCIP_VAR *var;
-    SCIP_CONSHDLRDATA *conshdlrdata;
-
-    conshdlrdata = SCIPconshdlrGetData(conshdlr);
+    // the name of the set is optional
+    int first = ntokens % 2;
+    double *values = (mps->section == MPS_RHS) ? mps->rhss : mps->ranges;
 
-    assert(scip == conshdlrdata->model->scip);
+    if (ntokens < 2 || ntokens > 5)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
 
-    for (i = 0; i < conshdlrdata->model->nvars; ++i)
+    for (int t = first; t < ntokens; t += 2)
     {
-        var = conshdlrdata->model->vars[i];
-        SCIP_CALL(SCIPaddVarLocks(scip, var, nlockspos + nlocksneg,
-                                  nlockspos + nlocksneg));
+        int row = findName(&mps->rownames, tokens[t].str, tokens[t].len);
+        double val;
+
+        if (row == -1 || !parseReal(tokens[t + 1], &val))
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+        // we have no objective offset and ignore free rows
+        if (row >= 0)
+        {
+            values[row] = val;
+        }
     }
 
-    return SCIP_OKAY;
+    return CSIP_RETCODE_OK;
 }
 
-/*
- * callback methods
- */
-
-CSIP_RETCODE CSIPaddLazyCallback(CSIP_MODEL *model, CSIP_LAZYCALLBACK callback,
-                                 void *userdata)
+static
+CSIP_RETCODE readMpsBound(CSIP_MPS *mps, int ntokens, CSIP_TOKEN *tokens)
 {
-    SCIP_CONSHDLRDATA *conshdlrdata;
-    SCIP_CONSHDLR *conshdlr;
-    SCIP *scip;
-    char name[SCIP_MAXSTRLEN];
-    int enfopriority;
-    int checkpriority;
-    int eagerfreq;
-    SCIP_Bool needscons = FALSE;
-
-    scip = model->scip;
-
-    /* cons_integral has enfo priority 0 and we want to be checked before */
-    enfopriority = 1;
-    /* we want to be checked as rarely as possible.
-     * -5000000 is the smallest proper value in SCIP's conshdlrs. */
-    checkpriority = -5000000 - 1;
-    /* no eager evaluations?! */
-    eagerfreq = -1;
-
-    SCIP_in_CSIP(SCIPallocMemory(scip, &conshdlrdata));
+    CSIP_TOKEN type = tokens[0];
+    SCIP_Bool hasvalue = !(tokenIs(type, "FR") || tokenIs(type, "MI")
+                           || tokenIs(type, "PL") || tokenIs(type, "BV"));
+    int namepos;
+    int col;
+    double val = 0.0;
+
+    // the name of the set is optional
+    if (ntokens == (hasvalue ? 4 : 3))
+    {
+        namepos = 2;
+    }
+    else if (ntokens == (hasvalue ? 3 : 2))
+    {
+        namepos = 1;
+    }
+    else
+    {
+        return CSIP_RETCODE_ERROR;
+    }
 
-    conshdlrdata->model = model;
-    conshdlrdata->callback = callback;
-    conshdlrdata->userdata = userdata;
+    col = findName(&mps->colnames, tokens[namepos].str, tokens[namepos].len);
+    if (col < 0 || (hasvalue && !parseReal(tokens[namepos + 1], &val)))
+    {
+        return CSIP_RETCODE_ERROR;
+    }
 
-    SCIPsnprintf(name, SCIP_MAXSTRLEN, "lazycons_%d", model->nlazycb);
-    SCIP_in_CSIP(SCIPincludeConshdlrBasic(
-                     scip, &conshdlr, name, "lazy constraint callback",
-                     enfopriority, checkpriority, eagerfreq, needscons,
-                     consEnfolpLazy, consEnfopsLazy, consCheckLazy, consLockLazy,
-                     conshdlrdata));
+    if (tokenIs(type, "UP") || tokenIs(type, "UI"))
+    {
+        // negative upper bound with default lower bound: lower bound is -inf
+        if (val < 0.0 && mps->lbs[col] == 0.0)
+        {
+            mps->lbs[col] = -mps->infinity;
+        }
+        mps->ubs[col] = val;
+    }
+    else if (tokenIs(type, "LO") || tokenIs(type, "LI"))
+    {
+        mps->lbs[col] = val;
+    }
+    else if (tokenIs(type, "FX"))
+    {
+        mps->lbs[col] = val;
+        mps->ubs[col] = val;
+    }
+    else if (tokenIs(type, "FR"))
+    {
+        mps->lbs[col] = -mps->infinity;
+        mps->ubs[col] = mps->infinity;
+    }
+    else if (tokenIs(type, "MI"))
+    {
+        mps->lbs[col] = -mps->infinity;
+    }
+    else if (tokenIs(type, "PL"))
+    {
+        mps->ubs[col] = mps->infinity;
+    }
+    else if (tokenIs(type, "BV"))
+    {
+        mps->lbs[col] = 0.0;
+        mps->ubs[col] = 1.0;
+        mps->types[col] = CSIP_VARTYPE_BINARY;
+    }
+    else
+    {
+        return CSIP_RETCODE_ERROR;
+    }
 
-    SCIP_in_CSIP(SCIPsetConshdlrFree(scip, conshdlr, consFreeLazy));
-    model->nlazycb += 1;
+    if (tokenIs(type, "UI") || tokenIs(type, "LI"))
+    {
+        mps->types[col] = CSIP_VARTYPE_INTEGER;
+    }
 
     return CSIP_RETCODE_OK;
 }
 
 static
-CSIP_RETCODE isSolIntegral(SCIP *scip, SCIP_SOL *sol, SCIP_Bool *integral)
+CSIP_RETCODE readMpsLine(CSIP_MPS *mps, const char *line, const char *end)
 {
-    // inspired by consCheckIntegral in cons_integral.c
-    SCIP_VAR **vars;
-    SCIP_Real solval;
-    int nbin, nint, nimpl, nallinteger;
+    CSIP_TOKEN tokens[MPS_MAXTOKENS];
+    int ntokens = 0;
+    const char *p = line;
 
-    SCIP_in_CSIP(SCIPgetSolVarsData(scip, sol, &vars, NULL,
-                                    &nbin, &nint, &nimpl, NULL));
+    // comments and empty lines
+    if (p == end || *p == '*')
+    {
+        return CSIP_RETCODE_OK;
+    }
 
-    *integral = TRUE;
-    nallinteger = nbin + nint + nimpl;
-    for (int v = 0; v < nallinteger; ++v)
+    while (p < end)
     {
-        solval = SCIPgetSolVal(scip, sol, vars[v]);
-        if (!SCIPisFeasIntegral(scip, solval))
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        {
+            ++p;
+        }
+        if (p == end)
         {
-            *integral = FALSE;
             break;
         }
+        if (ntokens == MPS_MAXTOKENS)
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+        tokens[ntokens].str = p;
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+        {
+            ++p;
+        }
+        tokens[ntokens].len = p - tokens[ntokens].str;
+        ++ntokens;
+    }
+    if (ntokens == 0)
+    {
+        return CSIP_RETCODE_OK;
     }
 
-    return CSIP_RETCODE_OK;
-}
+    // section headers start in the first column
+    if (*line != ' ' && *line != '\t')
+    {
+        if (tokenIs(tokens[0], "NAME"))
+        {
+            mps->section = MPS_NAME;
+        }
+        else if (tokenIs(tokens[0], "OBJSENSE"))
+        {
+            mps->section = MPS_OBJSENSE;
+            if (ntokens == 2)
+            {
+                mps->maximize = tokenIs(tokens[1], "MAX")
+                                || tokenIs(tokens[1], "MAXIMIZE");
+            }
+        }
+        else if (tokenIs(tokens[0], "ROWS"))
+        {
+            mps->section = MPS_ROWS;
+        }
+        else if (tokenIs(tokens[0], "COLUMNS"))
+        {
+            mps->section = MPS_COLUMNS;
+        }
+        else if (tokenIs(tokens[0], "RHS"))
+        {
+            mps->section = MPS_RHS;
+        }
+        else if (tokenIs(tokens[0], "RANGES"))
+        {
+            mps->section = MPS_RANGES;
+        }
+        else if (tokenIs(tokens[0], "BOUNDS"))
+        {
+            mps->section = MPS_BOUNDS;
+        }
+        else if (tokenIs(tokens[0], "ENDATA"))
+        {
+            mps->section = MPS_ENDATA;
+        }
+        else // e.g., SOS or quadratic sections
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+        return CSIP_RETCODE_OK;
+    }
 
+    switch (mps->section)
+    {
+    case MPS_OBJSENSE:
+        mps->maximize = tokenIs(tokens[0], "MAX")
+                        || tokenIs(tokens[0], "MAXIMIZE");
+        return CSIP_RETCODE_OK;
+    case MPS_ROWS:
+        return readMpsRow(mps, ntokens, tokens);
+    case MPS_COLUMNS:
+        return readMpsColumn(mps, ntokens, tokens);
+    case MPS_RHS:
+    case MPS_RANGES:
+        return readMpsRhs(mps, ntokens, tokens);
+    case MPS_BOUNDS:
+        return readMpsBound(mps, ntokens, tokens);
+    default:
+        return CSIP_RETCODE_ERROR;
+    }
+}
 
-CSIP_LAZY_CONTEXT CSIPlazyGetContext(CSIP_LAZYDATA *lazydata)
+// create variables and constraints from the parsed data
+static
+CSIP_RETCODE addMpsToModel(CSIP_MODEL *model, CSIP_MPS *mps)
 {
-    SCIP_Bool check = lazydata->checkonly;
-    SCIP_SOL *sol = check ? lazydata->sol : NULL;
-    SCIP_Bool integral = FALSE;
-    CSIP_CALL(isSolIntegral(lazydata->model->scip, sol, &integral));
+    CSIP_RETCODE retcode = CSIP_RETCODE_OK;
+    int firstvar = model->nvars;
+    size_t *rowbegin;
+    int *rowcols;
+    double *rowvals;
+    int *indices;
+
+    for (int j = 0; j < mps->ncols; ++j)
+    {
+        int type = mps->types[j];
 
-    if (integral)
+        // integer columns within [0,1] are binary
+        if (type == CSIP_VARTYPE_INTEGER && mps->lbs[j] >= 0.0
+                && mps->ubs[j] <= 1.0)
+        {
+            type = CSIP_VARTYPE_BINARY;
+        }
+        CSIP_CALL(CSIPaddVar(model, mps->lbs[j], mps->ubs[j], type, NULL));
+    }
+
+    indices = (int *) malloc(mps->ncols * sizeof(int));
+    if (mps->ncols > 0 && indices == NULL)
     {
-        return CSIP_LAZY_INTEGRALSOL;
+        return CSIP_RETCODE_NOMEMORY;
     }
-    else if (!check)
+    for (int j = 0; j < mps->ncols; ++j)
     {
-        return CSIP_LAZY_LPRELAX;
+        indices[j] = firstvar + j;
     }
-    else
+    CSIP_CALL(CSIPsetObj(model, mps->ncols, indices, mps->objs));
+    free(indices);
+
+    // transpose the column-wise entries to rows
+    rowbegin = (size_t *) calloc(mps->nrows + 1, sizeof(size_t));
+    rowcols = (int *) malloc(mps->nentries * sizeof(int));
+    rowvals = (double *) malloc(mps->nentries * sizeof(double));
+    if (rowbegin == NULL
+            || (mps->nentries > 0 && (rowcols == NULL || rowvals == NULL)))
     {
-        return CSIP_LAZY_OTHER;
+        free(rowbegin);
+        free(rowcols);
+        free(rowvals);
+        return CSIP_RETCODE_NOMEMORY;
     }
-}
+    for (size_t k = 0; k < mps->nentries; ++k)
+    {
+        ++rowbegin[mps->entryrows[k] + 1];
+    }
+    for (int i = 0; i < mps->nrows; ++i)
+    {
+        rowbegin[i + 1] += rowbegin[i];
+    }
+    for (size_t k = 0; k < mps->nentries; ++k)
+    {
+        // use rowbegin[row] as insertion position, shifted back below
+        size_t pos = rowbegin[mps->entryrows[k]]++;
+        rowcols[pos] = firstvar + mps->entrycols[k];
+        rowvals[pos] = mps->entryvals[k];
+    }
+    for (int i = mps->nrows; i > 0; --i)
+    {
+        rowbegin[i] = rowbegin[i - 1];
+    }
+    rowbegin[0] = 0;
+
+    for (int i = 0; i < mps->nrows && retcode == CSIP_RETCODE_OK; ++i)
+    {
+        double rhs = mps->rhss[i];
+        double range = fabs(mps->ranges[i]);
+        double lhs;
+
+        switch (mps->rowtypes[i])
+        {
+        case 'L':
+            lhs = (range != 0.0) ? rhs - range : -mps->infinity;
+            break;
+        case 'G':
+            lhs = rhs;
+            rhs = (range != 0.0) ? lhs + range : mps->infinity;
+            break;
+        default: // 'E'
+            lhs = rhs;
+            if (mps->ranges[i] > 0.0)
+            {
+                rhs = lhs + range;
+            }
+            else if (mps->ranges[i] < 0.0)
+            {
+                lhs = rhs - range;
+            }
+            break;
+        }
 
-/* returns LP or given solution depending whether we are called from check or enfo */
-CSIP_RETCODE CSIPlazyGetVarValues(CSIP_LAZYDATA *lazydata, double *output)
-{
-    int i;
-    SCIP *scip;
-    SCIP_VAR *var;
-    SCIP_SOL *sol;
+        retcode = CSIPaddLinCons(model, rowbegin[i + 1] - rowbegin[i],
+                                 rowcols + rowbegin[i], rowvals + rowbegin[i],
+                                 lhs, rhs, NULL);
+    }
 
-    scip = lazydata->model->scip;
-    sol = lazydata->checkonly ? lazydata->sol : NULL;
+    free(rowbegin);
+    free(rowcols);
+    free(rowvals);
 
-    for (i = 0; i < lazydata->model->nvars; ++i)
+    if (retcode == CSIP_RETCODE_OK && mps->maximize)
     {
-        var = lazydata->model->vars[i];
-        output[i] = SCIPgetSolVal(scip, sol, var);
+        retcode = CSIPsetSenseMaximize(model);
     }
 
-    return CSIP_RETCODE_OK;
+    return retcode;
 }
 
-CSIP_RETCODE CSIPlazyAddLinCons(CSIP_LAZYDATA *lazydata, int numindices,
-                                int *indices,
-                                double *coefs, double lhs, double rhs, int islocal)
+CSIP_RETCODE CSIPreadMPS(CSIP_MODEL *model, const char *filename)
 {
-    SCIP *scip;
-    SCIP_CONS *cons;
-    SCIP_SOL *sol;
-    SCIP_RESULT result;
-
-    scip = lazydata->model->scip;
-
-    if (lazydata->checkonly)
+    struct stat filestat;
+    const char *data;
+    const char *end;
+    const char *line;
+    CSIP_MPS mps;
+    CSIP_RETCODE retcode;
+    int fd;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+    if (fstat(fd, &filestat) != 0 || filestat.st_size == 0)
     {
-        sol = lazydata->sol;
+        close(fd);
+        return CSIP_RETCODE_ERROR;
     }
-    else
+    data = (const char *) mmap(NULL, filestat.st_size, PROT_READ, MAP_PRIVATE,
+                               fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
     {
-        sol = NULL;
+        return CSIP_RETCODE_ERROR;
     }
+    end = data + filestat.st_size;
 
-    /* Is it reasonable to assume that if we solved the problem, then the lazy constraint
-     * is satisfied in the original problem? We get the error:
-     * "method <SCIPcreateCons> cannot be called in the solved stage"
-     * and I am guessing this is because SCIP is checking whether the solution found in the
-     * presolved problem is feasible for the original problem. It could happen it is not feasible
-     * because of numerics mainly, hence the question in the comment
-     */
-    if (SCIPgetStage(scip) == SCIP_STAGE_SOLVED)
+    retcode = createMps(&mps, SCIPinfinity(model->scip));
+
+    for (line = data; line < end && retcode == CSIP_RETCODE_OK
+            && mps.section != MPS_ENDATA;)
     {
-        assert(lazydata->checkonly);
-        lazydata->feasible = TRUE; /* to be very explicit */
-        return CSIP_RETCODE_OK;
+        const char *eol = memchr(line, '\n', end - line);
+        if (eol == NULL)
+        {
+            eol = end;
+        }
+        retcode = readMpsLine(&mps, line, eol);
+        line = eol + 1;
     }
 
-    if (SCIPgetStage(scip) == SCIP_STAGE_TRANSFORMED)
+    if (retcode == CSIP_RETCODE_OK)
     {
-        // we can't even create a cons in this stage, we trust the user's judgement
-        lazydata->feasible = FALSE;
-        return CSIP_RETCODE_OK;
+        retcode = addMpsToModel(model, &mps);
     }
 
-    CSIP_CALL(createLinCons(lazydata->model, numindices, indices, coefs, lhs, rhs,
-                            &cons));
-    SCIP_in_CSIP(SCIPsetConsLocal(scip, cons, islocal == 1));
-    SCIP_in_CSIP(SCIPcheckCons(scip, cons, sol, FALSE, FALSE, FALSE, &result));
+    freeMps(&mps);
+    munmap((void *) data, filestat.st_size);
+
+    return retcode;
+}
+
+CSIP_RETCODE CSIPwriteProblem(CSIP_MODEL *model, const char *filename,
+                              const char *format)
+{
+    SCIP_RETCODE retcode;
+    FILE *file;
 
-    if (result == SCIP_INFEASIBLE)
+    // the constraint for copies of callbacks is not in the original problem
+    file = fopen(filename, "w");
+    if (file != NULL && setvbuf(file, NULL, _IOFBF, WRITEBUFFERSIZE) != 0)
     {
-        lazydata->feasible = FALSE;
+        fclose(file);
+        file = NULL;
     }
-
-    /* can not add constraints here */
-    if (SCIPgetStage(scip) == SCIP_STAGE_INIT
-            || SCIPgetStage(scip) == SCIP_STAGE_TRANSFORMING
-            || SCIPgetStage(scip) == SCIP_STAGE_INITSOLVE)
+    if (file == NULL)
     {
-        assert(lazydata->checkonly);
-        SCIP_in_CSIP(SCIPreleaseCons(lazydata->model->scip, &cons));
-        return CSIP_RETCODE_OK;
+        return CSIP_RETCODE_ERROR;
     }
 
-    /* we do not store cons, because the original problem does not contain them;
-     * and there is an issue when freeTransform is called
-     */
-    SCIP_in_CSIP(SCIPaddCons(scip, cons));
-    SCIP_in_CSIP(SCIPreleaseCons(lazydata->model->scip, &cons));
+    retcode = SCIPprintOrigProblem(model->scip, file, format, FALSE);
 
-    return CSIP_RETCODE_OK;
+    if (fclose(file) != 0 && retcode == SCIP_OKAY)
+    {
+        retcode = SCIP_WRITEERROR;
+    }
+
+    return retCodeSCIPtoCSIP(retcode);
 }
 
-/* Heuristic Plugin */
+/*
+ * names
+ */
 
-struct SCIP_HeurData
+static
+const char *getEntityName(CSIP_MODEL *model, SCIP_Bool isvar, int idx)
 {
-    CSIP_MODEL *model;
-    CSIP_HEURCALLBACK callback;
-    void *userdata;
-    SCIP_HEUR *heur;
-    unsigned int stored_sols;
-};
+    return isvar ? SCIPvarGetName(model->vars[idx])
+           : SCIPconsGetName(model->conss[idx]);
+}
 
+// get the name table of variables or constraints, building it if needed
 static
-SCIP_DECL_HEURFREE(heurFreeUser)
+CSIP_RETCODE getNameTable(CSIP_MODEL *model, SCIP_Bool isvar,
+                          CSIP_NAMETABLE **table)
 {
-    SCIP_HEURDATA *heurdata;
+    int n = isvar ? model->nvars : model->nconss;
 
-    heurdata = SCIPheurGetData(heur);
-    assert(heurdata != NULL);
+    *table = isvar ? &model->varnames : &model->consnames;
+    if ((*table)->names != NULL)
+    {
+        return CSIP_RETCODE_OK;
+    }
 
-    SCIPfreeMemory(scip, &heurdata);
-    SCIPheurSetData(heur, NULL);
+    CSIP_CALL(createNameTable(*table, n));
+    for (int i = 0; i < n; ++i)
+    {
+        const char *name = getEntityName(model, isvar, i);
+        CSIP_CALL(insertName(*table, name, strlen(name), i));
+    }
 
-    return SCIP_OKAY;
+    return CSIP_RETCODE_OK;
 }
 
+/* rename variables or constraints; the transformed problem is freed once for
+ * all of them */
 static
-SCIP_DECL_HEUREXEC(heurExecUser)
+CSIP_RETCODE setEntityNames(CSIP_MODEL *model, SCIP_Bool isvar, int numindices,
+                            int *indices, const char **names)
 {
-    SCIP_HEURDATA *heurdata = SCIPheurGetData(heur);
-    assert(heurdata != NULL);
+    CSIP_NAMETABLE *table;
 
-    *result = SCIP_DIDNOTFIND;
-    heurdata->stored_sols = 0;
+    for (int i = 0; i < numindices; ++i)
+    {
+        if (indices[i] < 0
+                || indices[i] >= (isvar ? model->nvars : model->nconss)
+                || names[i] == NULL)
+        {
+            return CSIP_RETCODE_ERROR;
+        }
+    }
 
-    CSIP_in_SCIP(heurdata->callback(heurdata->model, heurdata,
-                                    heurdata->userdata));
+    CSIP_CALL(getNameTable(model, isvar, &table));
+    CSIP_CALL(freeTransform(model));
 
-    if (heurdata->stored_sols > 0)
+    for (int i = 0; i < numindices; ++i)
     {
-        *result = SCIP_FOUNDSOL;
+        int idx = indices[i];
+        const char *name;
+
+        // the old name is freed by SCIP, so remove it first
+        name = getEntityName(model, isvar, idx);
+        if (findName(table, name, strlen(name)) == idx)
+        {
+            removeName(table, name, strlen(name));
+        }
+
+        if (isvar)
+        {
+            SCIP_in_CSIP(SCIPchgVarName(model->scip, model->vars[idx],
+                                        names[i]));
+        }
+        else
+        {
+            SCIP_in_CSIP(SCIPchgConsName(model->scip, model->conss[idx],
+                                         names[i]));
+        }
+
+        name = getEntityName(model, isvar, idx);
+        CSIP_CALL(insertName(table, name, strlen(name), idx));
     }
 
-    return SCIP_OKAY;
+    return CSIP_RETCODE_OK;
 }
 
-// Copy values of solution to output array. Call this function from your
-// heuristic callback. Solution is LP relaxation of current node.
-CSIP_RETCODE CSIPheurGetVarValues(CSIP_HEURDATA *heurdata, double *output)
+CSIP_RETCODE CSIPsetVarName(CSIP_MODEL *model, int idx, const char *name)
 {
-    CSIP_MODEL *model = heurdata->model;
-    SCIP_in_CSIP(SCIPgetSolVals(model->scip, NULL, model->nvars, model->vars,
-                                output));
-    return CSIP_RETCODE_OK;
+    return setEntityNames(model, TRUE, 1, &idx, &name);
 }
 
-// Supply a solution (as a dense array). Only complete solutions are supported.
-CSIP_RETCODE CSIPheurAddSolution(CSIP_HEURDATA *heurdata, double *values)
+CSIP_RETCODE CSIPsetConsName(CSIP_MODEL *model, int idx, const char *name)
 {
-    SCIP_SOL *sol;
-    CSIP_MODEL *model = heurdata->model;
-    SCIP *scip = model->scip;
-    unsigned int stored = 0;
+    return setEntityNames(model, FALSE, 1, &idx, &name);
+}
 
-    SCIP_in_CSIP(SCIPcreateSol(scip, &sol, heurdata->heur));
-    SCIP_in_CSIP(SCIPsetSolVals(scip, sol, model->nvars, model->vars, values));
-    SCIP_in_CSIP(SCIPtrySolFree(scip, &sol, FALSE, FALSE, TRUE, TRUE, TRUE, &stored));
+CSIP_RETCODE CSIPsetVarNames(CSIP_MODEL *model, int numindices, int *indices,
+                             const char **names)
+{
+    return setEntityNames(model, TRUE, numindices, indices, names);
+}
 
-    if (stored > 0)
+CSIP_RETCODE CSIPsetConsNames(CSIP_MODEL *model, int numindices, int *indices,
+                              const char **names)
+{
+    return setEntityNames(model, FALSE, numindices, indices, names);
+}
+
+int CSIPgetVarIndexByName(CSIP_MODEL *model, const char *name)
+{
+    CSIP_NAMETABLE *table;
+
+    if (getNameTable(model, TRUE, &table) != CSIP_RETCODE_OK)
     {
-        heurdata->stored_sols += 1;
+        return -1;
     }
 
-    return CSIP_RETCODE_OK;
+    return findName(table, name, strlen(name));
 }
 
-// Add a heuristic callback to the model.
-// You may use userdata to pass any data.
-CSIP_RETCODE CSIPaddHeuristicCallback(
-    CSIP_MODEL *model, CSIP_HEURCALLBACK callback, void *userdata)
+int CSIPgetConsIndexByName(CSIP_MODEL *model, const char *name)
 {
-    SCIP_HEURDATA *heurdata;
-    SCIP_HEUR *heur;
-    SCIP *scip;
-    char name[SCIP_MAXSTRLEN];
+    CSIP_NAMETABLE *table;
 
-    scip = model->scip;
+    if (getNameTable(model, FALSE, &table) != CSIP_RETCODE_OK)
+    {
+        return -1;
+    }
 
-    SCIP_in_CSIP(SCIPallocMemory(scip, &heurdata));
+    return findName(table, name, strlen(name));
+}
 
-    SCIPsnprintf(name, SCIP_MAXSTRLEN, "heur_%d", model->nheur);
-    SCIP_in_CSIP(SCIPincludeHeurBasic(
-                     scip, &heur, name, "heuristic callback", 'x',
-                     1, 1, 0, -1, SCIP_HEURTIMING_AFTERNODE, FALSE,
-                     heurExecUser, heurdata));
-    heurdata->model = model;
-    heurdata->callback = callback;
-    heurdata->userdata = userdata;
-    heurdata->heur = heur;
-    heurdata->stored_sols = 0;
+/*
+ * solution cache
+ */
 
-    SCIP_in_CSIP(SCIPsetHeurFree(scip, heur, heurFreeUser));
-    model->nheur += 1;
+struct csip_cache
+{
+    int capacity;
+    int nentries;
+    long long nuses;    // counter to find the least recently used entry
+    unsigned long long *fingerprints;
+    long long *lastuse;
+    int *nvars;
+    double *objvalues;
+    double **solutions;
+};
+
+CSIP_RETCODE CSIPcreateCache(CSIP_CACHE **cacheptr, int capacity)
+{
+    CSIP_CACHE *cache;
+
+    if (capacity <= 0)
+    {
+        return CSIP_RETCODE_ERROR;
+    }
+
+    *cacheptr = (CSIP_CACHE *) malloc(sizeof(CSIP_CACHE));
+    if (*cacheptr == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
+    cache = *cacheptr;
+
+    cache->capacity = capacity;
+    cache->nentries = 0;
+    cache->nuses = 0;
+    cache->fingerprints = (unsigned long long *) malloc(
+                              capacity * sizeof(unsigned long long));
+    cache->lastuse = (long long *) malloc(capacity * sizeof(long long));
+    cache->nvars = (int *) malloc(capacity * sizeof(int));
+    cache->objvalues = (double *) malloc(capacity * sizeof(double));
+    cache->solutions = (double **) malloc(capacity * sizeof(double *));
+    if (cache->fingerprints == NULL || cache->lastuse == NULL
+            || cache->nvars == NULL || cache->objvalues == NULL
+            || cache->solutions == NULL)
+    {
+        return CSIP_RETCODE_NOMEMORY;
+    }
 
     return CSIP_RETCODE_OK;
 }
 
-/*
- *  Message handler with a prefix
- */
+CSIP_RETCODE CSIPfreeCache(CSIP_CACHE *cache)
+{
+    for (int i = 0; i < cache->nentries; ++i)
+    {
+        free(cache->solutions[i]);
+    }
+    free(cache->fingerprints);
+    free(cache->lastuse);
+    free(cache->nvars);
+    free(cache->objvalues);
+    free(cache->solutions);
+    free(cache);
 
+    return CSIP_RETCODE_OK;
+}
 
-struct SCIP_MessagehdlrData
+CSIP_RETCODE CSIPsetCache(CSIP_MODEL *model, CSIP_CACHE *cache)
 {
-    char* prefix;
-};
+    model->cache = cache;
 
-static void logMessage(
-    SCIP_MESSAGEHDLR* messagehdlr, FILE* file, const char* msg)
+    return CSIP_RETCODE_OK;
+}
+
+// returns the entry of a model, or -1 if there is none
+static
+int findCacheEntry(CSIP_CACHE *cache, unsigned long long fingerprint,
+                   int nvars)
 {
-    SCIP_MESSAGEHDLRDATA* messagehdlrdata;
-    messagehdlrdata = SCIPmessagehdlrGetData(messagehdlr);
+    for (int i = 0; i < cache->nentries; ++i)
+    {
+        if (cache->fingerprints[i] == fingerprint && cache->nvars[i] == nvars)
+        {
+            return i;
+        }
+    }
 
-    fputs(messagehdlrdata->prefix, file);
-    fputs(msg, file);
-    fflush(file);
-    return;
+    return -1;
 }
 
-static SCIP_DECL_MESSAGEHDLRFREE(messageHdlrFree)
+static
+CSIP_RETCODE useCachedSolution(CSIP_MODEL *model,
+                               unsigned long long fingerprint)
 {
-    SCIP_MESSAGEHDLRDATA* messagehdlrdata = SCIPmessagehdlrGetData(messagehdlr);
-    free(messagehdlrdata->prefix);
-    SCIPfreeMemory(NULL, &messagehdlrdata);
-    return SCIP_OKAY;
+    CSIP_CACHE *cache = model->cache;
+    int entry = findCacheEntry(cache, fingerprint, model->nvars);
+
+    if (entry >= 0)
+    {
+        cache->lastuse[entry] = ++(cache->nuses);
+        CSIP_CALL(CSIPsetInitialSolution(model, cache->solutions[entry]));
+    }
+
+    return CSIP_RETCODE_OK;
 }
 
-CSIP_RETCODE CSIPsetMessagePrefix(CSIP_MODEL *model, const char* prefix)
+static
+CSIP_RETCODE storeCachedSolution(CSIP_MODEL *model,
+                                 unsigned long long fingerprint)
 {
-    SCIP_MESSAGEHDLR* messagehdlr = NULL;
-    SCIP_MESSAGEHDLRDATA* messagehdlrdata = NULL;
+    CSIP_CACHE *cache = model->cache;
+    double objvalue;
+    int entry;
 
-    SCIP_in_CSIP(SCIPallocMemory(NULL, &messagehdlrdata));
-    messagehdlrdata->prefix = strDup(prefix);
-    SCIP_in_CSIP(SCIPmessagehdlrCreate(&messagehdlr, FALSE, NULL, FALSE,
-                                       logMessage, logMessage, logMessage,
-                                       messageHdlrFree, messagehdlrdata));
+    if (SCIPgetBestSol(model->scip) == NULL)
+    {
+        return CSIP_RETCODE_OK;
+    }
+    objvalue = CSIPgetObjValue(model);
 
-    SCIP_in_CSIP(SCIPsetMessagehdlr(model->scip, messagehdlr));
-    SCIP_in_CSIP(SCIPmessagehdlrRelease(&messagehdlr));
+    entry = findCacheEntry(cache, fingerprint, model->nvars);
+    if (entry >= 0)
+    {
+        // keep the stored solution unless the new one is better; the sense is
+        // part of the fingerprint
+        SCIP_Bool maximize =
+            (SCIPgetObjsense(model->scip) == SCIP_OBJSENSE_MAXIMIZE);
+
+        cache->lastuse[entry] = ++(cache->nuses);
+        if (maximize ? objvalue <= cache->objvalues[entry]
+                : objvalue >= cache->objvalues[entry])
+        {
+            return CSIP_RETCODE_OK;
+        }
+    }
+    else
+    {
+        if (cache->nentries < cache->capacity)
+        {
+            entry = cache->nentries;
+            ++(cache->nentries);
+        }
+        else
+        {
+            // replace the least recently used entry
+            entry = 0;
+            for (int i = 1; i < cache->nentries; ++i)
+            {
+                if (cache->lastuse[i] < cache->lastuse[entry])
+                {
+                    entry = i;
+                }
+            }
+            free(cache->solutions[entry]);
+        }
+
+        cache->fingerprints[entry] = fingerprint;
+        cache->nvars[entry] = model->nvars;
+        cache->solutions[entry] = (double *) malloc(
+                                      model->nvars * sizeof(double));
+        if (model->nvars > 0 && cache->solutions[entry] == NULL)
+        {
+            return CSIP_RETCODE_NOMEMORY;
+        }
+    }
+
+    cache->lastuse[entry] = ++(cache->nuses);
+    cache->objvalues[entry] = objvalue;
+    CSIP_CALL(CSIPgetVarValues(model, cache->solutions[entry]));
 
     return CSIP_RETCODE_OK;
 }
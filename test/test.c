@@ -1,6 +1,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
 
 #include <csip.h>
 
@@ -1238,6 +1239,215 @@ static void test_heurcb()
     CHECK(CSIPfreeModel(m));
 }
 
+struct IncumbentData
+{
+    int ncalls;
+    double objval;
+    double values[2];
+};
+
+CSIP_RETCODE incumbentcb(CSIP_MODEL *model, CSIP_INCUMBENTDATA *incumbentdata,
+                         void *userdata)
+{
+    struct IncumbentData *data = (struct IncumbentData *) userdata;
+    int indices[] = {3, 4};
+    double objval = CSIPincumbentGetObjValue(incumbentdata);
+
+    // incumbents can only improve
+    mu_assert("Incumbent got worse!", data->ncalls == 0
+              || objval <= data->objval);
+
+    data->ncalls += 1;
+    data->objval = objval;
+    CHECK(CSIPincumbentGetVarValuesSparse(incumbentdata, 2, indices,
+                                          data->values));
+    return CSIP_RETCODE_OK;
+}
+
+static void test_incumbentcb()
+{
+    /*
+      Same MIP as in test_mip:
+      min -5x_1 - 3x_2 - 2x_3 - 7x_4 - 4x_5
+      s.t. 2x_1 + 8x_2 + 4x_3 + 2x_4 + 5x_5 <= 10
+      x Bin
+      solution is (1,0,0,1,1) with objval -16
+    */
+    int indices[] = {0, 1, 2, 3, 4};
+    double objcoef[] = { -5.0, -3.0, -2.0, -7.0, -4.0};
+    double conscoef[] = {2.0, 8.0, 4.0, 2.0, 5.0};
+    struct IncumbentData data = {0, 0.0, {0.0, 0.0}};
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+
+    for (int i = 0; i < 5; i++)
+    {
+        CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_BINARY, NULL));
+    }
+    CHECK(CSIPsetObj(m, 5, indices, objcoef));
+    CHECK(CSIPaddLinCons(m, 5, indices, conscoef, -INFINITY, 10.0, NULL));
+
+    CHECK(CSIPaddIncumbentCallback(m, incumbentcb, &data));
+
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+
+    // the last incumbent reported is the optimal solution
+    mu_assert("Incumbent callback not called!", data.ncalls >= 1);
+    mu_assert_near("Wrong incumbent value!", data.objval, -16.0);
+    mu_assert_near("Wrong incumbent solution!", data.values[0], 1.0);
+    mu_assert_near("Wrong incumbent solution!", data.values[1], 1.0);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+struct ProgressData
+{
+    int ncalls;
+    long long lastnnodes;
+};
+
+CSIP_RETCODE progresscb(CSIP_MODEL *model, CSIP_PROGRESS *progress,
+                        void *userdata)
+{
+    struct ProgressData *data = (struct ProgressData *) userdata;
+
+    mu_assert("Nodes not increasing!", progress->nnodes > data->lastnnodes);
+    mu_assert("Bounds inconsistent!",
+              progress->dualbound <= progress->primalbound + TOL);
+    mu_assert("Negative open nodes!", progress->nopennodes >= 0);
+
+    data->ncalls += 1;
+    data->lastnnodes = progress->nnodes;
+
+    // stop at the first report, like an early termination policy would
+    CHECK(CSIPinterrupt(model));
+    return CSIP_RETCODE_OK;
+}
+
+static void test_progresscb()
+{
+    // same MIP as in test_mip, reported on every node and interrupted
+    int indices[] = {0, 1, 2, 3, 4};
+    double objcoef[] = { -5.0, -3.0, -2.0, -7.0, -4.0};
+    double conscoef[] = {2.0, 8.0, 4.0, 2.0, 5.0};
+    struct ProgressData data = {0, 0};
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    // make sure at least the root node is processed
+    CHECK(CSIPsetIntParam(m, "presolving/maxrounds", 0));
+
+    for (int i = 0; i < 5; i++)
+    {
+        CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_BINARY, NULL));
+    }
+    CHECK(CSIPsetObj(m, 5, indices, objcoef));
+    CHECK(CSIPaddLinCons(m, 5, indices, conscoef, -INFINITY, 10.0, NULL));
+
+    CHECK(CSIPaddProgressCallback(m, 1, 0.0, progresscb, &data));
+
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong number of calls!", data.ncalls, 1);
+    mu_assert("Wrong status!", CSIPgetStatus(m) == CSIP_STATUS_USERLIMIT
+              || CSIPgetStatus(m) == CSIP_STATUS_OPTIMAL);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_solvestats()
+{
+    // same problem as in test_lazy, to also count the lazy callback calls
+    int objindices[] = {0, 1};
+    double objcoef[] = {0.5, 1.0};
+    double solution[2];
+    CSIP_SOLVESTATS stats;
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+
+    // no statistics before solving
+    mu_assert("Stats before solve!", CSIPgetSolveStats(m, &stats)
+              != CSIP_RETCODE_OK);
+
+    CHECK(CSIPaddVar(m, 0.0, 2.0, CSIP_VARTYPE_INTEGER, NULL));
+    CHECK(CSIPaddVar(m, 0.0, 2.0, CSIP_VARTYPE_INTEGER, NULL));
+    CHECK(CSIPsetObj(m, 2, objindices, objcoef));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    struct MyData userdata = { 10, &solution[0] };
+    CHECK(CSIPaddLazyCallback(m, lazy_callback, &userdata));
+
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+
+    CHECK(CSIPgetSolveStats(m, &stats));
+    mu_assert("Lazy callback not counted!", stats.nlazycalls > 0);
+    mu_assert("Negative lazy time!", stats.lazytime >= 0.0);
+    mu_assert_int("Heuristic callback counted!", (int) stats.nheurcalls, 0);
+    mu_assert("No nodes!", stats.nnodes >= 1);
+    mu_assert("Negative presolving time!", stats.presolvingtime >= 0.0);
+    mu_assert("No separators!", stats.nsepas > 0);
+    mu_assert("No heuristics!", stats.nheurs > 0);
+    mu_assert("Missing name!", stats.sepanames[0] != NULL
+              && stats.heurnames[0] != NULL);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_callbacktiming()
+{
+    // same problem as in test_lazy, with timing of the callback phases
+    int objindices[] = {0, 1};
+    double objcoef[] = {0.5, 1.0};
+    double solution[2];
+    long long ncalls;
+    double time;
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+
+    CHECK(CSIPaddVar(m, 0.0, 2.0, CSIP_VARTYPE_INTEGER, NULL));
+    CHECK(CSIPaddVar(m, 0.0, 2.0, CSIP_VARTYPE_INTEGER, NULL));
+    CHECK(CSIPsetObj(m, 2, objindices, objcoef));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    struct MyData userdata = { 10, &solution[0] };
+    CHECK(CSIPaddLazyCallback(m, lazy_callback, &userdata));
+    CHECK(CSIPsetCallbackTiming(m, 1));
+
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+
+    CHECK(CSIPgetCallbackTiming(m, CSIP_PHASE_LAZYCALLBACK, &ncalls, &time));
+    mu_assert("Lazy callback not timed!", ncalls > 0 && time >= 0.0);
+    CHECK(CSIPgetCallbackTiming(m, CSIP_PHASE_LAZYGETVARVALUES, &ncalls,
+                                &time));
+    mu_assert("CSIPlazyGetVarValues not timed!", ncalls > 0);
+    CHECK(CSIPgetCallbackTiming(m, CSIP_PHASE_HEURCALLBACK, &ncalls, &time));
+    mu_assert("Heuristic callback timed!", ncalls == 0);
+    mu_assert("Invalid phase accepted!", CSIPgetCallbackTiming(
+                  m, CSIP_NPHASES, &ncalls, &time) != CSIP_RETCODE_OK);
+
+    CHECK(CSIPwriteCallbackTiming(m, "callbacktiming.json"));
+    FILE *file = fopen("callbacktiming.json", "r");
+    mu_assert("JSON not written!", file != NULL && fgetc(file) == '{');
+    fclose(file);
+    remove("callbacktiming.json");
+
+    // disabling resets the counters
+    CHECK(CSIPsetCallbackTiming(m, 0));
+    CHECK(CSIPgetCallbackTiming(m, CSIP_PHASE_LAZYCALLBACK, &ncalls, &time));
+    mu_assert("Timing not reset!", ncalls == 0);
+
+    CHECK(CSIPfreeModel(m));
+}
+
 
 static void test_params()
 {
@@ -1270,6 +1480,1311 @@ static void test_prefix()
     // need to increase verblevel to see some output
 }
 
+static void test_prefix_buffered()
+{
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+
+    mu_assert("Invalid buffer size accepted!",
+              CSIPsetBufferedMessagePrefix(m, "", 0) != CSIP_RETCODE_OK);
+
+    // small buffer, to also exercise writing when full
+    char prefix[] = "test!buffered - ";
+    CHECK(CSIPsetBufferedMessagePrefix(m, prefix, 64));
+
+    CHECK(CSIPsolve(m));
+    CHECK(CSIPfreeModel(m));
+
+    // just checks that nothing crashes
+}
+
+struct LogData
+{
+    CSIP_MODEL *model;
+    int ninfo;
+};
+
+void logcb(CSIP_MODEL *model, CSIP_MSGTYPE msgtype, const char *msg,
+           void *userdata)
+{
+    struct LogData *data = (struct LogData *) userdata;
+    mu_assert("Wrong model in log callback!", model == data->model);
+    mu_assert("No message!", msg != NULL);
+    if (msgtype == CSIP_MSGTYPE_INFO)
+    {
+        data->ninfo += 1;
+    }
+}
+
+static void test_logcb()
+{
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    struct LogData data = {m, 0};
+
+    CHECK(CSIPsetLogCallback(m, logcb, &data, 4));
+    CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_BINARY, NULL));
+
+    CHECK(CSIPsolve(m));
+    mu_assert("No messages logged!", data.ninfo > 0);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+// write size bytes of data to a file
+static void writeFile(const char *filename, const char *data, long size)
+{
+    FILE *file = fopen(filename, "wb");
+    mu_assert("Could not open file!", file != NULL);
+    mu_assert("Could not write file!",
+              fwrite(data, 1, size, file) == (size_t) size);
+    fclose(file);
+}
+
+static void test_writeread()
+{
+    /*
+      Same NLP as in test_nlp, with some redundant constraints:
+      max x + y - z^3
+      s.t. z^2 <= 1
+      x + y >= -1
+      x^2 + y^2 <= 4
+      SOS1(x, y)
+      x, y <= 0
+      solution is 0, 0, -1
+    */
+    CSIP_OP ops[] = {VARIDX, CONST, POW};
+    int children[] = {2, 0, 0, 1};
+    int begin[] = {0, 1, 2, 4};
+    double values[] = {2.0};
+
+    CSIP_OP obj_ops[] = {VARIDX, VARIDX, VARIDX, CONST, POW, MINUS, SUM};
+    int obj_children[] = {0, 1, 2, 0, 2, 3, 4, 0, 1, 5};
+    int obj_begin[] = {0, 1, 2, 3, 4, 6, 7, 10};
+    double obj_values[] = {3.0};
+
+    int indices[] = {0, 1};
+    double coefs[] = {1.0, 1.0};
+
+    CSIP_MODEL *m;
+    CSIP_MODEL *m2;
+    double solution[3];
+    FILE *file;
+    char data[4096];
+    long size;
+    int badindex = 3;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPaddVar(m, -INFINITY, 0.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddVar(m, -INFINITY, 0.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddVar(m, -INFINITY, INFINITY, CSIP_VARTYPE_CONTINUOUS, NULL));
+
+    CHECK(CSIPaddNonLinCons(m, 3, ops, children, begin, values, -INFINITY, 1.0,
+                            NULL));
+    CHECK(CSIPaddLinCons(m, 2, indices, coefs, -1.0, INFINITY, NULL));
+    CHECK(CSIPaddQuadCons(m, 0, NULL, NULL, 2, indices, indices, coefs,
+                          -INFINITY, 4.0, NULL));
+    CHECK(CSIPaddSOS1(m, 2, indices, NULL, NULL));
+
+    CHECK(CSIPsetNonlinearObj(m, 7, obj_ops, obj_children, obj_begin,
+                              obj_values));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    CHECK(CSIPwriteModel(m, "writeread.csip"));
+    CHECK(CSIPfreeModel(m));
+
+    mu_assert("Read a missing file!",
+              CSIPreadModel("missing.csip", &m2) != CSIP_RETCODE_OK);
+
+    // truncated and corrupt files give no model
+    file = fopen("writeread.csip", "rb");
+    mu_assert("Could not open file!", file != NULL);
+    size = (long) fread(data, 1, sizeof(data), file);
+    fclose(file);
+    mu_assert("File too large!", size > 0 && size + 4 <= (long) sizeof(data));
+
+    for (long len = 0; len < size; len += 4)
+    {
+        writeFile("corrupt.csip", data, len);
+        mu_assert("Read a truncated file!",
+                  CSIPreadModel("corrupt.csip", &m2) != CSIP_RETCODE_OK);
+        mu_assert("Kept a truncated model!", m2 == NULL);
+    }
+
+    // trailing data
+    memset(&data[size], 0, 4);
+    writeFile("corrupt.csip", data, size + 4);
+    mu_assert("Read trailing data!",
+              CSIPreadModel("corrupt.csip", &m2) != CSIP_RETCODE_OK);
+    mu_assert("Kept a corrupt model!", m2 == NULL);
+
+    /* the last SOS1 index, followed by the SOS1 weights and the empty SOS2
+     * and indicator blocks, refers to a variable that does not exist */
+    memcpy(&data[size - 36], &badindex, sizeof(int));
+    writeFile("corrupt.csip", data, size);
+    mu_assert("Read a bad variable index!",
+              CSIPreadModel("corrupt.csip", &m2) != CSIP_RETCODE_OK);
+    mu_assert("Kept a corrupt model!", m2 == NULL);
+    remove("corrupt.csip");
+
+    CHECK(CSIPreadModel("writeread.csip", &m2));
+    remove("writeread.csip");
+    CHECK(CSIPsetIntParam(m2, "display/verblevel", 2));
+
+    mu_assert_int("Wrong number of vars!", CSIPgetNumVars(m2), 3);
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m2), 4);
+
+    CHECK(CSIPsolve(m2));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m2), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m2), 1.0);
+
+    CHECK(CSIPgetVarValues(m2, solution));
+    mu_assert_near("Wrong solution!", solution[0], 0.0);
+    mu_assert_near("Wrong solution!", solution[1], 0.0);
+    mu_assert_near("Wrong solution!", solution[2], -1.0);
+
+    CHECK(CSIPfreeModel(m2));
+}
+
+static void test_readmps()
+{
+    /*
+      max x + 2y
+      s.t. x + y <= 4
+      -2 <= x - y <= -1
+      x <= 10, y <= 3
+      y integer
+      solution is 1, 3
+    */
+    FILE *file;
+    CSIP_MODEL *m;
+    double solution[2];
+
+    file = fopen("readmps.mps", "w");
+    mu_assert("Could not write file!", file != NULL);
+    fprintf(file,
+            "* test problem\n"
+            "NAME          TEST\n"
+            "OBJSENSE\n"
+            "    MAX\n"
+            "ROWS\n"
+            " N  obj\n"
+            " L  c1\n"
+            " G  c2\n"
+            "COLUMNS\n"
+            "    x         obj       1.0          c1        1.0\n"
+            "    x         c2        1\n"
+            "    MARKER    'MARKER'  'INTORG'\n"
+            "    y         obj       2.0          c1        1.0\n"
+            "    y         c2        -1.0\n"
+            "    MARKER    'MARKER'  'INTEND'\n"
+            "RHS\n"
+            "    rhs       c1        4            c2        -2\n"
+            "RANGES\n"
+            "    rng       c2        1.0\n"
+            "BOUNDS\n"
+            " UP bnd       x         10\n"
+            " UP bnd       y         3\n"
+            "ENDATA\n");
+    fclose(file);
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 0));
+
+    mu_assert("Read a missing file!",
+              CSIPreadMPS(m, "missing.mps") != CSIP_RETCODE_OK);
+
+    // numbers without digits in the mantissa or exponent are errors
+    for (int i = 0; i < 3; ++i)
+    {
+        const char *badnumbers[] = {"-", "e5", "1e"};
+        FILE *badfile = fopen("badnumber.mps", "w");
+
+        mu_assert("Could not write file!", badfile != NULL);
+        fprintf(badfile,
+                "ROWS\n"
+                " N  obj\n"
+                " L  c1\n"
+                "COLUMNS\n"
+                "    x         c1        %s\n"
+                "ENDATA\n", badnumbers[i]);
+        fclose(badfile);
+        mu_assert("Read a bad number!",
+                  CSIPreadMPS(m, "badnumber.mps") != CSIP_RETCODE_OK);
+        remove("badnumber.mps");
+    }
+    mu_assert_int("Added vars from a bad file!", CSIPgetNumVars(m), 0);
+
+    CHECK(CSIPreadMPS(m, "readmps.mps"));
+    remove("readmps.mps");
+
+    mu_assert_int("Wrong number of vars!", CSIPgetNumVars(m), 2);
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 2);
+
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 7.0);
+
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[0], 1.0);
+    mu_assert_near("Wrong solution!", solution[1], 3.0);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_writeproblem()
+{
+    /*
+      max x + 2y
+      s.t. x + y <= 4
+      x, y >= 0
+    */
+    int indices[] = {0, 1};
+    double coefs[] = {1.0, 1.0};
+    double objcoefs[] = {1.0, 2.0};
+    char line[256];
+    int foundvar = 0;
+    int foundcons = 0;
+    FILE *file;
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPaddVar(m, 0.0, INFINITY, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddVar(m, 0.0, INFINITY, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddLinCons(m, 2, indices, coefs, -INFINITY, 4.0, NULL));
+    CHECK(CSIPsetObj(m, 2, indices, objcoefs));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    CHECK(CSIPwriteProblem(m, "writeproblem.lp", "lp"));
+
+    file = fopen("writeproblem.lp", "r");
+    mu_assert("Could not read file!", file != NULL);
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        foundvar |= (strstr(line, "x1") != NULL);
+        foundcons |= (strstr(line, "c0:") != NULL);
+    }
+    fclose(file);
+    remove("writeproblem.lp");
+
+    mu_assert("Variable name not found!", foundvar);
+    mu_assert("Constraint name not found!", foundcons);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_names()
+{
+    double lbs[] = {0.0, 0.0, 0.0};
+    double ubs[] = {1.0, 1.0, 1.0};
+    CSIP_VARTYPE types[] = {CSIP_VARTYPE_BINARY, CSIP_VARTYPE_BINARY,
+                            CSIP_VARTYPE_BINARY
+                           };
+    const char *names[] = {"alpha", NULL, "gamma"};
+    int indices[] = {0, 1};
+    double coefs[] = {1.0, 1.0};
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPaddVars(m, 3, lbs, ubs, types, names));
+    CHECK(CSIPaddLinCons(m, 2, indices, coefs, -INFINITY, 1.0, NULL));
+
+    mu_assert_int("Wrong number of vars!", CSIPgetNumVars(m), 3);
+    mu_assert_int("Wrong index!", CSIPgetVarIndexByName(m, "alpha"), 0);
+    mu_assert_int("Wrong index!", CSIPgetVarIndexByName(m, "x1"), 1);
+    mu_assert_int("Wrong index!", CSIPgetVarIndexByName(m, "gamma"), 2);
+    mu_assert_int("Wrong index!", CSIPgetVarIndexByName(m, "delta"), -1);
+    mu_assert_int("Wrong index!", CSIPgetConsIndexByName(m, "c0"), 0);
+
+    // the table is kept up to date after it is built
+    CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_BINARY, NULL));
+    mu_assert_int("Wrong index!", CSIPgetVarIndexByName(m, "x3"), 3);
+
+    CHECK(CSIPsetVarName(m, 2, "delta"));
+    mu_assert_int("Wrong index!", CSIPgetVarIndexByName(m, "delta"), 2);
+    mu_assert_int("Wrong index!", CSIPgetVarIndexByName(m, "gamma"), -1);
+
+    CHECK(CSIPsetConsName(m, 0, "knapsack"));
+    mu_assert_int("Wrong index!", CSIPgetConsIndexByName(m, "knapsack"), 0);
+    mu_assert_int("Wrong index!", CSIPgetConsIndexByName(m, "c0"), -1);
+
+    // renaming several at once
+    CHECK(CSIPaddLinCons(m, 2, indices, coefs, -INFINITY, 1.0, NULL));
+    {
+        int consindices[] = {0, 1};
+        const char *consnames[] = {"first", "second"};
+
+        CHECK(CSIPsetConsNames(m, 2, consindices, consnames));
+        mu_assert_int("Wrong index!", CSIPgetConsIndexByName(m, "first"), 0);
+        mu_assert_int("Wrong index!", CSIPgetConsIndexByName(m, "second"), 1);
+        mu_assert_int("Wrong index!", CSIPgetConsIndexByName(m, "c1"), -1);
+    }
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_chgobj()
+{
+    /*
+      max 2x + y
+      s.t. x + y <= 1
+      x, y >= 0
+      solution is 1, 0; after changing coefficient of y to 3 it is 0, 1
+    */
+    int indices[] = {0, 1};
+    double coefs[] = {1.0, 1.0};
+    double objcoefs[] = {2.0, 1.0};
+    int chgindex = 1;
+    double chgcoef = 3.0;
+    double solution[2];
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 0));
+    CHECK(CSIPaddVar(m, 0.0, INFINITY, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddVar(m, 0.0, INFINITY, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddLinCons(m, 2, indices, coefs, -INFINITY, 1.0, NULL));
+    CHECK(CSIPsetObj(m, 2, indices, objcoefs));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 2.0);
+
+    // unchanged coefficients keep the solved problem
+    CHECK(CSIPchgObjCoefs(m, 2, indices, objcoefs));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 2.0);
+
+    CHECK(CSIPchgObjCoefs(m, 1, &chgindex, &chgcoef));
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 3.0);
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[0], 0.0);
+    mu_assert_near("Wrong solution!", solution[1], 1.0);
+
+    CHECK(CSIPclearObj(m));
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 0.0);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_lexicographic()
+{
+    /*
+      lexmax (x + y, y)
+      s.t. x + y <= 1
+      x, y binary
+      solution is 0, 1 with objective values 1, 1
+    */
+    int indices[] = {0, 1};
+    double coefs[] = {1.0, 1.0};
+    int objbegin[] = {0, 2, 3};
+    int objindices[] = {0, 1, 1};
+    double objcoefs[] = {1.0, 1.0, 1.0};
+    double objvalues[2];
+    double solution[2];
+    int considx;
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 0));
+    CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_BINARY, NULL));
+    CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_BINARY, NULL));
+    CHECK(CSIPaddLinCons(m, 2, indices, coefs, -INFINITY, 1.0, NULL));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    CHECK(CSIPsolveLexicographic(m, 2, objbegin, objindices, objcoefs, NULL,
+                                 objvalues, &considx));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", objvalues[0], 1.0);
+    mu_assert_near("Wrong objective value!", objvalues[1], 1.0);
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 2);
+
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[0], 0.0);
+    mu_assert_near("Wrong solution!", solution[1], 1.0);
+
+    // the constraint on x + y is removed again
+    mu_assert_int("Wrong cons index!", considx, 1);
+    CHECK(CSIPdelConss(m, 1, &considx, NULL));
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 1);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_scenarios()
+{
+    /*
+      max x + y
+      s.t. x + y <= 1
+      0 <= x, y <= 10
+      scenarios: rhs 2, rhs 3, and x, y <= 0.25
+    */
+    int indices[] = {0, 1};
+    double coefs[] = {1.0, 1.0};
+    int considx = 0;
+    double lhs = -INFINITY;
+    double rhss[] = {2.0, 3.0};
+    double lbs[] = {0.0, 0.0};
+    double ubs[] = {0.25, 0.25};
+    CSIP_SCENARIO scenarios[] =
+    {
+        {1, &considx, &lhs, &rhss[0], 0, NULL, NULL, NULL},
+        {1, &considx, &lhs, &rhss[1], 0, NULL, NULL, NULL},
+        {0, NULL, NULL, NULL, 2, indices, lbs, ubs}
+    };
+    CSIP_STATUS statuses[3];
+    double objvalues[3];
+    double solvalues[6];
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 0));
+    CHECK(CSIPaddVar(m, 0.0, 10.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddVar(m, 0.0, 10.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddLinCons(m, 2, indices, coefs, -INFINITY, 1.0, NULL));
+    CHECK(CSIPsetObj(m, 2, indices, coefs));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    CHECK(CSIPsolveScenarios(m, 3, scenarios, 2, indices, statuses, objvalues,
+                             solvalues));
+
+    for (int s = 0; s < 3; ++s)
+    {
+        mu_assert_int("Wrong status!", statuses[s], CSIP_STATUS_OPTIMAL);
+    }
+    mu_assert_near("Wrong objective value!", objvalues[0], 2.0);
+    mu_assert_near("Wrong objective value!", objvalues[1], 3.0);
+    mu_assert_near("Wrong objective value!", objvalues[2], 0.5);
+    mu_assert_near("Wrong solution!", solvalues[4], 0.25);
+    mu_assert_near("Wrong solution!", solvalues[5], 0.25);
+
+    // the model is restored afterwards
+    CHECK(CSIPsolve(m));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 1.0);
+
+    // enough scenarios to keep several threads busy
+    {
+        CSIP_SCENARIO many[16];
+        double manyrhss[16];
+        CSIP_STATUS manystatuses[16];
+        double manyobjvalues[16];
+
+        for (int s = 0; s < 16; ++s)
+        {
+            manyrhss[s] = 0.5 * s;
+            many[s] = scenarios[0];
+            many[s].rhss = &manyrhss[s];
+        }
+        CHECK(CSIPsolveScenarios(m, 16, many, 0, NULL, manystatuses,
+                                 manyobjvalues, NULL));
+        for (int s = 0; s < 16; ++s)
+        {
+            mu_assert_int("Wrong status!", manystatuses[s],
+                          CSIP_STATUS_OPTIMAL);
+            mu_assert_near("Wrong objective value!", manyobjvalues[s],
+                           0.5 * s);
+        }
+    }
+
+    // invalid scenarios are rejected before solving any
+    {
+        int badidx = 2;
+        int sosidx;
+        CSIP_SCENARIO bad[] =
+        {
+            {1, &considx, &lhs, &rhss[0], 0, NULL, NULL, NULL},
+            {0, NULL, NULL, NULL, 1, &badidx, lbs, ubs}
+        };
+
+        mu_assert("Solved scenario with bad variable!",
+                  CSIPsolveScenarios(m, 2, bad, 0, NULL, statuses, NULL, NULL)
+                  != CSIP_RETCODE_OK);
+        bad[1].nvars = 0;
+        bad[1].nconss = 1;
+        bad[1].consindices = &badidx;
+        bad[1].lhss = &lhs;
+        bad[1].rhss = &rhss[0];
+        mu_assert("Solved scenario with bad constraint!",
+                  CSIPsolveScenarios(m, 2, bad, 0, NULL, statuses, NULL, NULL)
+                  != CSIP_RETCODE_OK);
+
+        // SOS constraints have no sides
+        CHECK(CSIPaddSOS1(m, 2, indices, NULL, &sosidx));
+        bad[1].consindices = &sosidx;
+        mu_assert("Changed sides of SOS constraint!",
+                  CSIPsolveScenarios(m, 2, bad, 0, NULL, statuses, NULL, NULL)
+                  != CSIP_RETCODE_OK);
+        CHECK(CSIPdelConss(m, 1, &sosidx, NULL));
+
+        CHECK(CSIPsolve(m));
+        mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 1.0);
+    }
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void build_knapsack(CSIP_MODEL *m, double capacity)
+{
+    int indices[] = {0, 1, 2};
+    double weights[] = {2.0, 3.0, 4.0};
+    double values[] = {3.0, 4.0, 5.0};
+
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 0));
+    for (int i = 0; i < 3; ++i)
+    {
+        CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_BINARY, NULL));
+    }
+    CHECK(CSIPaddLinCons(m, 3, indices, weights, -INFINITY, capacity, NULL));
+    CHECK(CSIPsetObj(m, 3, indices, values));
+    CHECK(CSIPsetSenseMaximize(m));
+}
+
+static void test_cache()
+{
+    CSIP_CACHE *cache;
+    CSIP_MODEL *m1;
+    CSIP_MODEL *m2;
+    CSIP_MODEL *m3;
+    CSIP_MODEL *m4;
+    unsigned long long fp1;
+    unsigned long long fp2;
+    unsigned long long fp3;
+    int idx = 0;
+    double zero = 0.0;
+    double one = 1.0;
+    double worse[] = {1.0, 0.0, 0.0};
+
+    CHECK(CSIPcreateModel(&m1));
+    CHECK(CSIPcreateModel(&m2));
+    CHECK(CSIPcreateModel(&m3));
+    build_knapsack(m1, 5.0);
+    build_knapsack(m2, 5.0);
+    build_knapsack(m3, 6.0);
+
+    CHECK(CSIPgetFingerprint(m1, &fp1));
+    CHECK(CSIPgetFingerprint(m2, &fp2));
+    CHECK(CSIPgetFingerprint(m3, &fp3));
+    mu_assert("Fingerprints differ!", fp1 == fp2);
+    mu_assert("Fingerprints are equal!", fp1 != fp3);
+
+    // the stored fingerprint follows changes of the model
+    CHECK(CSIPchgVarUB(m1, 1, &idx, &zero));
+    CHECK(CSIPgetFingerprint(m1, &fp2));
+    mu_assert("Fingerprint not updated!", fp1 != fp2);
+    CHECK(CSIPchgVarUB(m1, 1, &idx, &one));
+    CHECK(CSIPgetFingerprint(m1, &fp2));
+    mu_assert("Fingerprint not updated!", fp1 == fp2);
+
+    CHECK(CSIPcreateCache(&cache, 1));
+    CHECK(CSIPsetCache(m1, cache));
+    CHECK(CSIPsetCache(m2, cache));
+    CHECK(CSIPsetCache(m3, cache));
+
+    CHECK(CSIPsolve(m1));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m1), 7.0);
+
+    // starts from the cached solution of m1
+    CHECK(CSIPsolve(m2));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m2), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m2), 7.0);
+
+    /* a worse solution of the same model, stopped at its given initial
+     * solution, does not replace the cached one; the next solve stops at the
+     * cached solution
+     */
+    CHECK(CSIPcreateModel(&m4));
+    build_knapsack(m4, 5.0);
+    CHECK(CSIPsetCache(m4, cache));
+    CHECK(CSIPsetIntParam(m4, "limits/solutions", 1));
+    CHECK(CSIPsetIntParam(m4, "presolving/maxrounds", 0));
+    CHECK(CSIPsetInitialSolution(m4, worse));
+    CHECK(CSIPsolve(m4));
+    CHECK(CSIPchgVarUB(m4, 1, &idx, &one));
+    CHECK(CSIPsolve(m4));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m4), 7.0);
+    CHECK(CSIPfreeModel(m4));
+
+    // replaces the entry of m1
+    CHECK(CSIPsolve(m3));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m3), 8.0);
+
+    CHECK(CSIPfreeModel(m1));
+    CHECK(CSIPfreeModel(m2));
+    CHECK(CSIPfreeModel(m3));
+    CHECK(CSIPfreeCache(cache));
+}
+
+static void test_initialsol_multiple()
+{
+    /*
+      Knapsack from test_cache with capacity 5, solution 1, 1, 0
+      Give two complete solutions, the second optimal, and a sparse one that
+      can only be completed to 0, 0, 1. Without processing any node, the
+      objective value is the best of the given solutions: 3, 5 and 7.
+    */
+    double sol1[] = {1.0, 0.0, 0.0};
+    double sol2[] = {1.0, 1.0, 0.0};
+    int sparseindices[] = {2};
+    double sparsevalues[] = {1.0};
+    int badindex = 3;
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    build_knapsack(m, 5.0);
+    CHECK(CSIPsetLongintParam(m, "limits/nodes", 0));
+    CHECK(CSIPsetIntParam(m, "presolving/maxrounds", 0));
+    CHECK(CSIPsetIntParam(m, "heuristics/completesol/freq", 0));
+
+    mu_assert("Sparse solution with invalid index accepted!",
+              CSIPaddInitialSolutionSparse(m, 1, &badindex, sparsevalues)
+              != CSIP_RETCODE_OK);
+
+    CHECK(CSIPaddInitialSolution(m, sol1));
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_NODELIMIT);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 3.0);
+
+    // the sparse solution after a complete one
+    CHECK(CSIPaddInitialSolution(m, sol1));
+    CHECK(CSIPaddInitialSolutionSparse(m, 1, sparseindices, sparsevalues));
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_NODELIMIT);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 5.0);
+
+    // the best solution given last
+    CHECK(CSIPaddInitialSolution(m, sol1));
+    CHECK(CSIPaddInitialSolutionSparse(m, 1, sparseindices, sparsevalues));
+    CHECK(CSIPaddInitialSolution(m, sol2));
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_NODELIMIT);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 7.0);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_lazy_copy()
+{
+    /*
+       same problem as in test_lazy, but with the sub-MIP heuristics running,
+       which copy the lazy constraint handler
+     */
+
+    int objindices[] = {0, 1};
+    double objcoef[] = {0.5, 1.0};
+    double solution[2];
+
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    CHECK(CSIPsetIntParam(m, "heuristics/rens/freq", 1));
+    CHECK(CSIPsetIntParam(m, "heuristics/rins/freq", 1));
+    CHECK(CSIPsetRealParam(m, "heuristics/rens/minfixingrate", 0.0));
+
+    CHECK(CSIPaddVar(m, 0.0, 2.0, CSIP_VARTYPE_INTEGER, NULL));
+    CHECK(CSIPaddVar(m, 0.0, 2.0, CSIP_VARTYPE_INTEGER, NULL));
+    CHECK(CSIPsetObj(m, 2, objindices, objcoef));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    struct MyData userdata = { 10, &solution[0] };
+
+    CHECK(CSIPaddLazyCallback(m, lazy_callback, &userdata));
+
+    CHECK(CSIPsolve(m));
+
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective!", CSIPgetObjValue(m), 2.5);
+
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[0], 1.0);
+    mu_assert_near("Wrong solution!", solution[1], 2.0);
+
+    // the constraint that carries the model to the copies is not written
+    {
+        char line[256];
+        int foundmodelcons = 0;
+        FILE *file;
+
+        CHECK(CSIPwriteProblem(m, "lazycopy.cip", "cip"));
+        file = fopen("lazycopy.cip", "r");
+        mu_assert("Could not read file!", file != NULL);
+        while (fgets(line, sizeof(line), file) != NULL)
+        {
+            foundmodelcons |= (strstr(line, "csip_model") != NULL);
+        }
+        fclose(file);
+        remove("lazycopy.cip");
+        mu_assert("Model constraint written!", !foundmodelcons);
+
+        // the model still solves with its callback afterwards
+        CHECK(CSIPsolve(m));
+        mu_assert_near("Wrong objective!", CSIPgetObjValue(m), 2.5);
+    }
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_swapnlobj()
+{
+    /*
+      min x^2, set 5 times
+      s.t. 1 <= x <= 2
+      the problem should hold a single objective constraint
+    */
+    CSIP_OP ops[] = {VARIDX, CONST, POW};
+    int children[] = {0, 0, 0, 1};
+    int begin[] = {0, 1, 2, 4};
+    double values[] = {2.0};
+    char line[256];
+    int nobjconss = 0;
+    FILE *file;
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    CHECK(CSIPaddVar(m, 1.0, 2.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+
+    for (int i = 0; i < 5; ++i)
+    {
+        CHECK(CSIPsetNonlinearObj(m, 3, ops, children, begin, values));
+    }
+
+    CHECK(CSIPwriteProblem(m, "swapnlobj.cip", "cip"));
+
+    file = fopen("swapnlobj.cip", "r");
+    mu_assert("Could not read file!", file != NULL);
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        nobjconss += (strstr(line, "nonlin_obj") != NULL);
+    }
+    fclose(file);
+    remove("swapnlobj.cip");
+
+    mu_assert_int("Old objective constraints left!", nobjconss, 1);
+
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 1.0);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_delete()
+{
+    /*
+      max x0 + x1 + x2 + x3
+      s.t. x0 + x1 <= 1 (deleted)
+           x2 + x3 <= 2
+           x1 + x3 <= 3
+      0 <= x <= 1, x0 and x2 deleted
+      solution is x1 = x3 = 1
+    */
+    int indices[] = {0, 1, 2, 3};
+    double coefs[] = {1.0, 1.0, 1.0, 1.0};
+    int delvars[] = {2, 0};
+    int delconss[] = {0};
+    int newvarindices[4];
+    int newconsindices[3];
+    double solution[2];
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    for (int i = 0; i < 4; ++i)
+    {
+        CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    }
+    CHECK(CSIPaddLinCons(m, 2, &indices[0], coefs, -INFINITY, 1.0, NULL));
+    CHECK(CSIPaddLinCons(m, 2, &indices[2], coefs, -INFINITY, 2.0, NULL));
+    indices[0] = 1;
+    indices[1] = 3;
+    CHECK(CSIPaddLinCons(m, 2, indices, coefs, -INFINITY, 3.0, NULL));
+    indices[0] = 0;
+    indices[1] = 1;
+    CHECK(CSIPsetObj(m, 4, indices, coefs));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    CHECK(CSIPdelVars(m, 2, delvars, newvarindices));
+    CHECK(CSIPdelConss(m, 1, delconss, newconsindices));
+
+    mu_assert_int("Wrong number of vars!", CSIPgetNumVars(m), 2);
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 2);
+    mu_assert_int("Wrong var index!", newvarindices[0], -1);
+    mu_assert_int("Wrong var index!", newvarindices[1], 0);
+    mu_assert_int("Wrong var index!", newvarindices[2], -1);
+    mu_assert_int("Wrong var index!", newvarindices[3], 1);
+    mu_assert_int("Wrong cons index!", newconsindices[0], -1);
+    mu_assert_int("Wrong cons index!", newconsindices[2], 1);
+    mu_assert_int("Wrong name lookup!", CSIPgetVarIndexByName(m, "x3"), 1);
+    mu_assert_int("Wrong name lookup!", CSIPgetConsIndexByName(m, "c0"), -1);
+
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 2.0);
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[0], 1.0);
+    mu_assert_near("Wrong solution!", solution[1], 1.0);
+
+    // new variables get fresh default names
+    CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    mu_assert_int("Wrong name lookup!", CSIPgetVarIndexByName(m, "x4"), 2);
+
+    // variables of other constraints cannot be deleted, even if inactive
+    {
+        int sosindices[] = {0, 2};
+        int sosidx;
+        int x4 = 2;
+
+        CHECK(CSIPaddSOS1(m, 2, sosindices, NULL, &sosidx));
+        CHECK(CSIPsetConsActive(m, 1, &sosidx, 0));
+        mu_assert("Deleted variable of SOS constraint!",
+                  CSIPdelVars(m, 1, &x4, NULL) != CSIP_RETCODE_OK);
+        mu_assert_int("Wrong number of vars!", CSIPgetNumVars(m), 3);
+
+        CHECK(CSIPdelConss(m, 1, &sosidx, NULL));
+        CHECK(CSIPdelVars(m, 1, &x4, NULL));
+        mu_assert_int("Wrong number of vars!", CSIPgetNumVars(m), 2);
+    }
+
+    // invalid indices are rejected without changes
+    {
+        int badindices[] = {0, 5};
+
+        mu_assert("Deleted invalid variable!",
+                  CSIPdelVars(m, 2, badindices, NULL) != CSIP_RETCODE_OK);
+        mu_assert("Deleted invalid constraint!",
+                  CSIPdelConss(m, 2, badindices, NULL) != CSIP_RETCODE_OK);
+        mu_assert_int("Wrong number of vars!", CSIPgetNumVars(m), 2);
+        mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 2);
+
+        CHECK(CSIPsolve(m));
+        mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 2.0);
+    }
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_consactive()
+{
+    /*
+      max x + y
+      s.t. x <= 1 (group "caps")
+           y <= 1 (group "caps")
+           x + y <= 3
+      0 <= x, y <= 2
+    */
+    int indices[] = {0, 1};
+    double coefs[] = {1.0, 1.0};
+    int caps[] = {0, 1};
+    int first = 0;
+    double solution[2];
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    CHECK(CSIPaddVar(m, 0.0, 2.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddVar(m, 0.0, 2.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddLinCons(m, 1, &indices[0], coefs, -INFINITY, 1.0, NULL));
+    CHECK(CSIPaddLinCons(m, 1, &indices[1], coefs, -INFINITY, 1.0, NULL));
+    CHECK(CSIPaddLinCons(m, 2, indices, coefs, -INFINITY, 3.0, NULL));
+    CHECK(CSIPsetObj(m, 2, indices, coefs));
+    CHECK(CSIPsetSenseMaximize(m));
+    CHECK(CSIPaddConsGroup(m, "caps", 2, caps));
+
+    CHECK(CSIPsolve(m));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 2.0);
+
+    CHECK(CSIPsetConsGroupActive(m, "caps", 0));
+    mu_assert_int("Constraint still active!", CSIPisConsActive(m, 1), 0);
+    CHECK(CSIPsolve(m));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 3.0);
+
+    CHECK(CSIPsetConsActive(m, 1, &first, 1));
+    CHECK(CSIPsolve(m));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 3.0);
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[0], 1.0);
+
+    CHECK(CSIPsetConsGroupActive(m, "caps", 1));
+    mu_assert_int("Constraint not active!", CSIPisConsActive(m, 0), 1);
+    mu_assert_int("Constraint not active!", CSIPisConsActive(m, 1), 1);
+    CHECK(CSIPsolve(m));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 2.0);
+
+    // a second cycle works as the first one
+    CHECK(CSIPsetConsGroupActive(m, "caps", 0));
+    mu_assert_int("Constraint still active!", CSIPisConsActive(m, 0), 0);
+    CHECK(CSIPsolve(m));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 3.0);
+
+    // inactive constraints are kept in model files
+    CHECK(CSIPsetConsActive(m, 1, &first, 1));
+    CHECK(CSIPwriteModel(m, "consactive.csip"));
+    CHECK(CSIPfreeModel(m));
+    CHECK(CSIPreadModel("consactive.csip", &m));
+    remove("consactive.csip");
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    mu_assert_int("Constraint not active!", CSIPisConsActive(m, 0), 1);
+    mu_assert_int("Constraint still active!", CSIPisConsActive(m, 1), 0);
+    mu_assert_int("Constraint not active!", CSIPisConsActive(m, 2), 1);
+    CHECK(CSIPsolve(m));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 3.0);
+
+    mu_assert("Unknown group accepted!",
+              CSIPsetConsGroupActive(m, "none", 0) != CSIP_RETCODE_OK);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_solvewithfixings()
+{
+    /*
+      max 2x + y
+      s.t. x + y <= 1
+      x, y binary
+      solution is x = 1, and y = 1 under the fixing x = 0
+    */
+    int indices[] = {0, 1};
+    double coefs[] = {1.0, 1.0};
+    double objcoefs[] = {2.0, 1.0};
+    double value = 0.0;
+    double solution[2];
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_BINARY, NULL));
+    CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_BINARY, NULL));
+    CHECK(CSIPaddLinCons(m, 2, indices, coefs, -INFINITY, 1.0, NULL));
+    CHECK(CSIPsetObj(m, 2, indices, objcoefs));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    CHECK(CSIPsolveWithFixings(m, 1, &indices[0], &value));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 1.0);
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[0], 0.0);
+    mu_assert_near("Wrong solution!", solution[1], 1.0);
+
+    // the fixing is gone in the next solve
+    CHECK(CSIPsolve(m));
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 2.0);
+
+    // an initial solution given after a solve with fixings survives the
+    // removal of the fixings
+    CHECK(CSIPsolveWithFixings(m, 1, &indices[0], &value));
+    solution[0] = 1.0;
+    solution[1] = 0.0;
+    CHECK(CSIPaddInitialSolution(m, solution));
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 2.0);
+
+    // values outside the bounds are rejected
+    value = 2.0;
+    mu_assert("Fixing outside bounds accepted!",
+              CSIPsolveWithFixings(m, 1, &indices[0], &value)
+              != CSIP_RETCODE_OK);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_indicator()
+{
+    /*
+      max x + z - 0.1 y
+      s.t. z = 1 -> x <= 2
+           z = 0 -> x <= 1
+           y >= 1
+      0 <= x, y <= 10, z binary, y semicontinuous with y = 0 or y >= 4
+      solution is x = 2, z = 1, y = 4
+    */
+    int xidx = 0;
+    int yidx = 1;
+    int objindices[] = {0, 1, 2};
+    double objcoefs[] = {1.0, -0.1, 1.0};
+    double zero = 0.0;
+    double one = 1.0;
+    double semilb = 4.0;
+    int binindices[] = {2, 2};
+    int activevals[] = {1, 0};
+    int begin[] = {0, 1, 2};
+    int indices[] = {0, 0};
+    double coefs[] = {1.0, 1.0};
+    double lhss[] = {-INFINITY, -INFINITY};
+    double rhss[] = {2.0, 1.0};
+    int considx[2];
+    double solution[3];
+    CSIP_MODEL *m;
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    CHECK(CSIPaddVar(m, 0.0, 10.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddVar(m, 0.0, 10.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_BINARY, NULL));
+
+    CHECK(CSIPaddIndicators(m, 2, binindices, activevals, begin, indices,
+                            coefs, lhss, rhss, considx));
+    mu_assert_int("Wrong cons index!", considx[0], 0);
+    mu_assert_int("Wrong cons index!", considx[1], 1);
+
+    // an invalid row adds none of the rows
+    binindices[1] = 0;
+    mu_assert("Indicator on continuous variable accepted!",
+              CSIPaddIndicators(m, 2, binindices, activevals, begin, indices,
+                                coefs, lhss, rhss, NULL) != CSIP_RETCODE_OK);
+    binindices[1] = 2;
+    indices[1] = 3;
+    mu_assert("Indicator with invalid index accepted!",
+              CSIPaddIndicators(m, 2, binindices, activevals, begin, indices,
+                                coefs, lhss, rhss, NULL) != CSIP_RETCODE_OK);
+    indices[1] = 0;
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 2);
+
+    // a semicontinuous variable needs a lower bound of 0
+    CHECK(CSIPchgVarLB(m, 1, &yidx, &one));
+    mu_assert("Semicontinuous with lower bound 1 accepted!",
+              CSIPaddSemicontinuous(m, 1, &yidx, &semilb) != CSIP_RETCODE_OK);
+    CHECK(CSIPchgVarLB(m, 1, &yidx, &zero));
+
+    // and a semicontinuous lower bound in (0, ub]
+    mu_assert("Semicontinuous lower bound 0 accepted!",
+              CSIPaddSemicontinuous(m, 1, &yidx, &zero) != CSIP_RETCODE_OK);
+    semilb = 11.0;
+    mu_assert("Semicontinuous lower bound above ub accepted!",
+              CSIPaddSemicontinuous(m, 1, &yidx, &semilb) != CSIP_RETCODE_OK);
+    semilb = 4.0;
+
+    CHECK(CSIPaddSemicontinuous(m, 1, &yidx, &semilb));
+    CHECK(CSIPaddLinCons(m, 1, &yidx, &one, 1.0, INFINITY, NULL));
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 4);
+
+    CHECK(CSIPsetObj(m, 3, objindices, objcoefs));
+    CHECK(CSIPsetSenseMaximize(m));
+    CHECK(CSIPsolve(m));
+
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 2.6);
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[xidx], 2.0);
+    mu_assert_near("Wrong solution!", solution[yidx], 4.0);
+    mu_assert_near("Wrong solution!", solution[2], 1.0);
+
+    /* the linear rows of the indicator constraints follow their indicator
+     * constraints; without z = 1 -> x <= 2, x goes up to its bound
+     */
+    CHECK(CSIPsetConsActive(m, 1, &considx[0], 0));
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 10.6);
+
+    CHECK(CSIPsetConsActive(m, 1, &considx[0], 1));
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 2.6);
+
+    CHECK(CSIPdelConss(m, 1, &considx[0], NULL));
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 3);
+    mu_assert_int("Wrong number of vars!", CSIPgetNumVars(m), 3);
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 10.6);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_sos2batch()
+{
+    // max 2x + 3y + 4z + 4u + 3v + 2w
+    //     SOS2(x, y, z), SOS2(u, v, w)
+    //     0 <= x, y, z, u, v, w <= 1
+    //
+    // sol -> (0, 1, 1, 1, 1, 0)
+
+    CSIP_MODEL *m;
+    int objindices[] = {0, 1, 2, 3, 4, 5};
+    double objcoef[] = {2.0, 3.0, 4.0, 4.0, 3.0, 2.0};
+    int begin[] = {0, 3, 6};
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    for (int i = 0; i < 6; ++i)
+    {
+        CHECK(CSIPaddVar(m, 0.0, 1.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    }
+    CHECK(CSIPaddSOS2Batch(m, 2, begin, objindices, NULL));
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 2);
+    CHECK(CSIPsetSenseMaximize(m));
+    CHECK(CSIPsetObj(m, 6, objindices, objcoef));
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 14.0);
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_piecewise()
+{
+    // max y - 0.5x
+    //     y = f(x), f through (0, 0), (2, 4), (4, 2)
+    //
+    // sol -> x = 2, y = 4
+
+    CSIP_MODEL *m;
+    int objindices[] = {0, 1};
+    double objcoef[] = {-0.5, 1.0};
+    double xs[] = {0.0, 2.0, 4.0};
+    double ys[] = {0.0, 4.0, 2.0};
+    double solution[5];
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    CHECK(CSIPaddVar(m, -INFINITY, INFINITY, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddVar(m, -INFINITY, INFINITY, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddPiecewiseLinear(m, 0, 1, 3, xs, ys));
+    mu_assert_int("Wrong number of vars!", CSIPgetNumVars(m), 5);
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 4);
+    CHECK(CSIPsetSenseMaximize(m));
+    CHECK(CSIPsetObj(m, 2, objindices, objcoef));
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 3.0);
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[0], 2.0);
+    mu_assert_near("Wrong solution!", solution[1], 4.0);
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_nlp_ops()
+{
+    /*
+      min |x - 1| + y^2
+      s.t. x + y >= 2 (as polynomial)
+           max(x, y) <= 1.5
+      -10 <= x <= 1
+      solution is 1, 1
+    */
+    CSIP_OP obj_ops[] = {VARIDX, VARIDX, LINEAR, OPABS, CONST, OPINTPOWER,
+                         LINEAR};
+    int obj_children[] = {0, 1, 0, 0, 1, 2, 2, 1, 4, 3, 5, 3, 4, 5};
+    int obj_begin[] = {0, 1, 2, 5, 6, 7, 9, 14};
+    double obj_values[] = {1.0, -1.0, 2.0, 1.0, 1.0, 0.0};
+
+    CSIP_OP poly_ops[] = {VARIDX, VARIDX, POLYNOMIAL};
+    int poly_children[] = {0, 1, 2, 0, 1, 0, 1, 1, 0, 2, 1, 1, 1, 2};
+    int poly_begin[] = {0, 1, 2, 14};
+    double poly_values[] = {0.0, 1.0, 1.0};
+
+    CSIP_OP max_ops[] = {VARIDX, VARIDX, OPMAX};
+    int max_children[] = {0, 1, 0, 1};
+    int max_begin[] = {0, 1, 2, 4};
+
+    CSIP_MODEL *m;
+    double solution[2];
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    CHECK(CSIPaddVar(m, -10.0, 1.0, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddVar(m, -INFINITY, INFINITY, CSIP_VARTYPE_CONTINUOUS, NULL));
+    CHECK(CSIPaddNonLinCons(m, 3, poly_ops, poly_children, poly_begin,
+                            poly_values, 2.0, INFINITY, NULL));
+    CHECK(CSIPaddNonLinCons(m, 3, max_ops, max_children, max_begin, NULL,
+                            -INFINITY, 1.5, NULL));
+    CHECK(CSIPsetNonlinearObj(m, 7, obj_ops, obj_children, obj_begin,
+                              obj_values));
+
+    // the new operators survive writing and reading the model
+    CHECK(CSIPwriteModel(m, "nlpops.csip"));
+    CHECK(CSIPfreeModel(m));
+    CHECK(CSIPreadModel("nlpops.csip", &m));
+    remove("nlpops.csip");
+
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 1.0);
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[0], 1.0);
+    mu_assert_near("Wrong solution!", solution[1], 1.0);
+
+    CHECK(CSIPfreeModel(m));
+}
+
+static void test_nlp_univariate()
+{
+    /*
+      max x + y
+      s.t. sin(x) + cos(x) >= 1
+           x^2 + y^2 <= 5 (as quadratic node)
+           min(x, y^2) >= 1
+      x in {0, .., 3}, y in {-3, .., 3}
+      solution is 1, 2
+    */
+    int indices[] = {0, 1};
+    double objcoefs[] = {1.0, 1.0};
+
+    CSIP_OP trig_ops[] = {VARIDX, OPSIN, OPCOS, SUM};
+    int trig_children[] = {0, 0, 0, 1, 2};
+    int trig_begin[] = {0, 1, 2, 3, 5};
+
+    CSIP_OP quad_ops[] = {VARIDX, VARIDX, QUADRATIC};
+    int quad_children[] = {0, 1, 2, 0, 1, 0, 1, 2, 0, 0, 3, 1, 1, 3};
+    int quad_begin[] = {0, 1, 2, 14};
+    double quad_values[] = {0.0, 0.0, 0.0, 1.0};
+
+    CSIP_OP min_ops[] = {VARIDX, VARIDX, OPSQUARE, OPMIN};
+    int min_children[] = {0, 1, 1, 0, 2};
+    int min_begin[] = {0, 1, 2, 3, 5};
+
+    // x^2.5 as OPINTPOWER, and a quadratic term with a third child
+    CSIP_OP pow_ops[] = {VARIDX, CONST, OPINTPOWER};
+    int pow_children[] = {0, 0, 0, 1};
+    int pow_begin[] = {0, 1, 2, 4};
+    double pow_values[] = {2.5};
+    int badquad_children[] = {0, 1, 2, 0, 1, 0, 1, 2, 0, 0, 3, 1, 2, 3};
+
+    CSIP_MODEL *m;
+    double solution[2];
+
+    CHECK(CSIPcreateModel(&m));
+    CHECK(CSIPsetIntParam(m, "display/verblevel", 2));
+    CHECK(CSIPaddVar(m, 0.0, 3.0, CSIP_VARTYPE_INTEGER, NULL));
+    CHECK(CSIPaddVar(m, -3.0, 3.0, CSIP_VARTYPE_INTEGER, NULL));
+    CHECK(CSIPaddNonLinCons(m, 4, trig_ops, trig_children, trig_begin, NULL,
+                            1.0, INFINITY, NULL));
+    CHECK(CSIPaddNonLinCons(m, 3, quad_ops, quad_children, quad_begin,
+                            quad_values, -INFINITY, 5.0, NULL));
+    CHECK(CSIPaddNonLinCons(m, 4, min_ops, min_children, min_begin, NULL,
+                            1.0, INFINITY, NULL));
+    CHECK(CSIPsetObj(m, 2, indices, objcoefs));
+    CHECK(CSIPsetSenseMaximize(m));
+
+    // invalid expressions are rejected without adding anything
+    mu_assert("Fractional integer power accepted!",
+              CSIPaddNonLinCons(m, 3, pow_ops, pow_children, pow_begin,
+                                pow_values, -INFINITY, 1.0, NULL)
+              != CSIP_RETCODE_OK);
+    mu_assert("Quadratic term out of range accepted!",
+              CSIPaddNonLinCons(m, 3, quad_ops, badquad_children, quad_begin,
+                                quad_values, -INFINITY, 5.0, NULL)
+              != CSIP_RETCODE_OK);
+    mu_assert_int("Wrong number of conss!", CSIPgetNumConss(m), 3);
+
+    CHECK(CSIPsolve(m));
+    mu_assert_int("Wrong status!", CSIPgetStatus(m), CSIP_STATUS_OPTIMAL);
+    mu_assert_near("Wrong objective value!", CSIPgetObjValue(m), 3.0);
+    CHECK(CSIPgetVarValues(m, solution));
+    mu_assert_near("Wrong solution!", solution[0], 1.0);
+    mu_assert_near("Wrong solution!", solution[1], 2.0);
+
+    CHECK(CSIPfreeModel(m));
+}
+
 int main(int argc, char **argv)
 {
     printf("Running tests...\n");
@@ -1299,8 +2814,33 @@ int main(int argc, char **argv)
     mu_run_test(test_initialsol_partial);
     mu_run_test(test_initialsol_nlp_partial);
     mu_run_test(test_heurcb);
+    mu_run_test(test_incumbentcb);
+    mu_run_test(test_progresscb);
+    mu_run_test(test_solvestats);
+    mu_run_test(test_callbacktiming);
     mu_run_test(test_params);
     mu_run_test(test_prefix);
+    mu_run_test(test_prefix_buffered);
+    mu_run_test(test_logcb);
+    mu_run_test(test_writeread);
+    mu_run_test(test_readmps);
+    mu_run_test(test_writeproblem);
+    mu_run_test(test_names);
+    mu_run_test(test_chgobj);
+    mu_run_test(test_lexicographic);
+    mu_run_test(test_scenarios);
+    mu_run_test(test_cache);
+    mu_run_test(test_initialsol_multiple);
+    mu_run_test(test_lazy_copy);
+    mu_run_test(test_swapnlobj);
+    mu_run_test(test_delete);
+    mu_run_test(test_consactive);
+    mu_run_test(test_solvewithfixings);
+    mu_run_test(test_indicator);
+    mu_run_test(test_sos2batch);
+    mu_run_test(test_piecewise);
+    mu_run_test(test_nlp_ops);
+    mu_run_test(test_nlp_univariate);
 
     printf("All tests passed!\n");
     return 0;